@@ -81,7 +81,7 @@ bool ChatChannel::addUser(const PlayerPtr& player)
 	if (id == CHANNEL_GUILD) {
 		auto guild = player->getGuild();
 		if (guild && !guild->getMotd().empty()) {
-			g_scheduler.addEvent(createSchedulerTask(150, [playerID = player->getID()]() { g_game.sendGuildMotd(playerID); }));
+			g_scheduler.addEvent(createSchedulerTask("Game::sendGuildMotd", 150, [playerID = player->getID()]() { g_game.sendGuildMotd(playerID); }));
 		}
 	}
 
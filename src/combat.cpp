@@ -17,84 +17,85 @@ extern Weapons* g_weapons;
 extern ConfigManager g_config;
 extern Events* g_events;
 
-// we use a thread-local tile buffer for reuse across calls to avoid repeated allocations
-thread_local std::vector<TilePtr> area_tile_buffer;
+namespace {
 
-static std::vector<TilePtr> getList(const MatrixArea& area, const Position& targetPos, const Direction dir) 
-{
-	const Position casterPos = getNextPosition(dir, targetPos);
+// spare tile lists for area combats, reused across calls to avoid repeated allocations;
+// a combat started from a tile callback of another one takes a list of its own
+thread_local std::vector<std::vector<TilePtr>> area_tile_buffers;
 
-	const uint32_t rows = area.getRows();
-	const uint32_t cols = area.getCols();
-	const auto& center = area.getCenter();
+class AreaTileBuffer
+{
+	public:
+		AreaTileBuffer() {
+			if (!area_tile_buffers.empty()) {
+				tiles = std::move(area_tile_buffers.back());
+				area_tile_buffers.pop_back();
+			}
+		}
+		~AreaTileBuffer() {
+			tiles.clear();
+			area_tile_buffers.push_back(std::move(tiles));
+		}
 
-	const int32_t startX = targetPos.x - static_cast<int32_t>(center.first);
-	const int32_t startY = targetPos.y - static_cast<int32_t>(center.second);
-	const uint32_t z = targetPos.z;
+		// non-copyable
+		AreaTileBuffer(const AreaTileBuffer&) = delete;
+		AreaTileBuffer& operator=(const AreaTileBuffer&) = delete;
 
-	area_tile_buffer.clear();
-	area_tile_buffer.reserve(rows * cols);
+		std::vector<TilePtr> tiles;
+};
 
-	Position pos(0, 0, z);
+void getList(const std::vector<AreaOffset>& offsets, const Position& targetPos, const Direction dir, std::vector<TilePtr>& tiles)
+{
+	const Position casterPos = getNextPosition(dir, targetPos);
+	tiles.reserve(offsets.size());
 
-	for (uint32_t row = 0; row < rows; ++row) 
+	Position pos(0, 0, targetPos.z);
+	for (const AreaOffset& offset : offsets) 
 	{
-		pos.y = startY + static_cast<int32_t>(row);
+		pos.x = targetPos.x + offset.x;
+		pos.y = targetPos.y + offset.y;
 
-		for (uint32_t col = 0; col < cols; ++col) 
+		[[unlikely]]
+		if (not g_game.isSightClear(casterPos, pos, true))
 		{
-			[[unlikely]]
-			if (not area(row, col))  
-			{
-				continue;
-			}
-
-			pos.x = startX + static_cast<int32_t>(col);
-
-			[[unlikely]]
-			if (not g_game.isSightClear(casterPos, pos, true))
-			{
-				continue;
-			}
-
-			auto tile = g_game.map.getTile(pos);
-			[[unlikely]]
-			if (not tile)
-			{
-				tile = std::make_shared<Tile>(pos.x, pos.y, z);
-				g_game.map.setTile(pos, tile);
-			}
+			continue;
+		}
 
-			area_tile_buffer.push_back(tile);
+		auto tile = g_game.map.getTile(pos);
+		[[unlikely]]
+		if (not tile)
+		{
+			tile = g_game.map.createVirtualTile(pos);
 		}
-	}
 
-	return area_tile_buffer;
+		tiles.push_back(std::move(tile));
+	}
 }
 
-
-std::vector<TilePtr> getCombatArea(const Position& centerPos, const Position& targetPos, const AreaCombat* area)
+void getCombatArea(const Position& centerPos, const Position& targetPos, const AreaCombat* area, std::vector<TilePtr>& tiles)
 {
 	[[unlikely]]
 	if (targetPos.z >= MAP_MAX_LAYERS) 
 	{
-		return {};
+		return;
 	}
 
 	[[likely]]
 	if (area) 
 	{
-		return getList(area->getArea(centerPos, targetPos), targetPos, getDirectionTo(targetPos, centerPos));
+		getList(area->getOffsets(centerPos, targetPos), targetPos, getDirectionTo(targetPos, centerPos), tiles);
+		return;
 	}
 
 	auto tile = g_game.map.getTile(targetPos);
 	[[unlikely]]
 	if (not tile) 
 	{
-		tile = std::make_shared<Tile>(targetPos.x, targetPos.y, targetPos.z);
-		g_game.map.setTile(targetPos, tile);
+		tile = g_game.map.createVirtualTile(targetPos);
 	}
-	return {tile};
+	tiles.push_back(std::move(tile));
+}
+
 }
 
 CombatDamage Combat::getCombatDamage(const CreaturePtr& creature, const CreaturePtr& target) const
@@ -864,8 +865,9 @@ void Combat::doCombat(const CreaturePtr& caster, const Position& position) const
 	}
 	else 
 	{
-		const auto& currentArea = area.get();
-		const auto& tiles = caster ? getCombatArea(caster->getPosition(), position, currentArea) : getCombatArea(position, position, currentArea);
+		AreaTileBuffer buffer;
+		const auto& tiles = buffer.tiles;
+		getCombatArea(caster ? caster->getPosition() : position, position, area.get(), buffer.tiles);
 
 		if (tiles.empty()) 
 		{
@@ -1428,7 +1430,9 @@ void Combat::doTargetCombat(const CreaturePtr& caster, const CreaturePtr& target
 void Combat::doAreaCombat(const CreaturePtr& caster, const Position& position, const AreaCombat* area, const CombatDamage& damage, const CombatParams& params)
 {
 	const auto& p = params;
-	const auto& tiles = caster ? getCombatArea(caster->getPosition(), position, area) :	getCombatArea(position, position, area);
+	AreaTileBuffer buffer;
+	const auto& tiles = buffer.tiles;
+	getCombatArea(caster ? caster->getPosition() : position, position, area, buffer.tiles);
 
 	if (tiles.empty()) 
 	{
@@ -1748,7 +1752,7 @@ void TargetCallback::onTargetCombat(const CreaturePtr& creature, const CreatureP
 	scriptInterface->resetScriptEnv();
 }
 
-const MatrixArea& AreaCombat::getArea(const Position& centerPos, const Position& targetPos) const {
+const std::vector<AreaOffset>& AreaCombat::getOffsets(const Position& centerPos, const Position& targetPos) const {
 	const int32_t dx = Position::getOffsetX(targetPos, centerPos);
 	const int32_t dy = Position::getOffsetY(targetPos, centerPos);
 
@@ -1776,25 +1780,42 @@ const MatrixArea& AreaCombat::getArea(const Position& centerPos, const Position&
 	}
 
 	[[unlikely]]
-	if (dir >= areas.size()) {
+	if (dir >= offsets.size()) {
 		// log location
-		static MatrixArea empty;
+		static const std::vector<AreaOffset> empty;
 		return empty;
 	}
-	return areas[dir];
+	return offsets[dir];
+}
+
+std::vector<AreaOffset> AreaCombat::getOffsets(const MatrixArea& area)
+{
+	const auto& center = area.getCenter();
+
+	std::vector<AreaOffset> list;
+	for (uint32_t row = 0; row < area.getRows(); ++row) {
+		for (uint32_t col = 0; col < area.getCols(); ++col) {
+			if (area(row, col)) {
+				list.push_back({static_cast<int16_t>(static_cast<int32_t>(col) - static_cast<int32_t>(center.first)),
+					static_cast<int16_t>(static_cast<int32_t>(row) - static_cast<int32_t>(center.second))});
+			}
+		}
+	}
+	list.shrink_to_fit();
+	return list;
 }
 
 void AreaCombat::setupArea(const std::vector<uint32_t>& vec, uint32_t rows)
 {
-	auto area = createArea(vec, rows);
-	if (areas.size() == 0) {
-		areas.resize(4);
+	const auto area = createArea(vec, rows);
+	if (offsets.size() == 0) {
+		offsets.resize(4);
 	}
 
-	areas[DIRECTION_EAST] = area.rotate90();
-	areas[DIRECTION_SOUTH] = area.rotate180();
-	areas[DIRECTION_WEST] = area.rotate270();
-	areas[DIRECTION_NORTH] = std::move(area);
+	offsets[DIRECTION_EAST] = getOffsets(area.rotate90());
+	offsets[DIRECTION_SOUTH] = getOffsets(area.rotate180());
+	offsets[DIRECTION_WEST] = getOffsets(area.rotate270());
+	offsets[DIRECTION_NORTH] = getOffsets(area);
 }
 
 void AreaCombat::setupArea(int32_t length, int32_t spread)
@@ -1874,12 +1895,12 @@ void AreaCombat::setupExtArea(const std::vector<uint32_t>& vec, uint32_t rows)
 	}
 
 	hasExtArea = true;
-	auto area = createArea(vec, rows);
-	areas.resize(8);
-	areas[DIRECTION_NORTHEAST] = area.rotate90();
-	areas[DIRECTION_SOUTHEAST] = area.rotate180();
-	areas[DIRECTION_SOUTHWEST] = area.rotate270();
-	areas[DIRECTION_NORTHWEST] = std::move(area);
+	const auto area = createArea(vec, rows);
+	offsets.resize(8);
+	offsets[DIRECTION_NORTHEAST] = getOffsets(area.rotate90());
+	offsets[DIRECTION_SOUTHEAST] = getOffsets(area.rotate180());
+	offsets[DIRECTION_SOUTHWEST] = getOffsets(area.rotate270());
+	offsets[DIRECTION_NORTHWEST] = getOffsets(area);
 }
 
 void MagicField::onStepInField(const CreaturePtr& creature)
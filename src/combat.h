@@ -68,6 +68,12 @@ struct CombatParams {
 	bool ignoreResistances = false;
 };
 
+// position of an area tile relative to the target of the area
+struct AreaOffset {
+	int16_t x;
+	int16_t y;
+};
+
 class AreaCombat
 {
 	public:
@@ -75,11 +81,15 @@ class AreaCombat
 		void setupArea(int32_t length, int32_t spread);
 		void setupArea(int32_t radius);
 		void setupExtArea(const std::vector<uint32_t>& vec, uint32_t rows);
-		const MatrixArea& getArea(const Position& centerPos, const Position& targetPos) const;
-		
+
+		// the tiles of the area facing from centerPos to targetPos, in row order of the area
+		const std::vector<AreaOffset>& getOffsets(const Position& centerPos, const Position& targetPos) const;
 
 	private:
-		std::vector<MatrixArea> areas;
+		static std::vector<AreaOffset> getOffsets(const MatrixArea& area);
+
+		// one list per direction, worked out when the area is set up
+		std::vector<std::vector<AreaOffset>> offsets;
 		bool hasExtArea = false;
 };
 
@@ -258,6 +258,14 @@ bool ConfigManager::load()
 	boolean[HEALTH_REGEN_NOTIFICATION] = getGlobalBoolean(L, "healthRegenNotification", false);
 	boolean[MANA_REGEN_NOTIFICATION] = getGlobalBoolean(L, "manaRegenNotification", false);
     boolean[AUTO_OPEN_CONTAINERS] = getGlobalBoolean(L, "autoOpenContainers", true);
+	boolean[SCHEDULER_TIMER_WHEEL] = getGlobalBoolean(L, "schedulerTimerWheel", false);
+	boolean[DISPATCHER_PROFILER] = getGlobalBoolean(L, "dispatcherProfiler", false);
+	boolean[PARALLEL_CREATURE_THINK] = getGlobalBoolean(L, "parallelCreatureThink", false);
+	boolean[MAP_LEAF_GRID] = getGlobalBoolean(L, "mapLeafGrid", true);
+	boolean[PARALLEL_MAP_LOADING] = getGlobalBoolean(L, "parallelMapLoading", true);
+	boolean[FLOW_FIELD_PATHING] = getGlobalBoolean(L, "flowFieldPathing", false);
+	boolean[ASYNC_PATHFINDING] = getGlobalBoolean(L, "asyncPathfinding", false);
+	boolean[HIERARCHICAL_PATHFINDING] = getGlobalBoolean(L, "hierarchicalPathfinding", true);
 
 	// Account manager
 	boolean[ENABLE_ACCOUNT_MANAGER] = getGlobalBoolean(L, "useIngameAccountManager", true);
@@ -315,6 +323,10 @@ bool ConfigManager::load()
 	integer[PARTY_EXP_SHARE_FLOORS] = getGlobalNumber(L, "partyExpShareFloors", 1);
 	integer[MAXIMUM_PARTY_SIZE] = getGlobalNumber(L, "maximumPartySize", 10);
 	integer[MAXIMUM_INVITE_COUNT] = getGlobalNumber(L, "maximumInviteCount", 20);
+	integer[DISPATCHER_PROFILER_INTERVAL] = getGlobalNumber(L, "dispatcherProfilerInterval", 60000);
+	integer[PARALLEL_CREATURE_THINK_THREADS] = getGlobalNumber(L, "parallelCreatureThinkThreads", 0);
+	integer[ASYNC_PATHFINDING_THREADS] = getGlobalNumber(L, "asyncPathfindingThreads", 1);
+	integer[NETWORK_THREADS] = getGlobalNumber(L, "networkThreads", 1);
 
 	floats[REWARD_BASE_RATE] = getGlobalFloat(L, "rewardBaseRate", 1.0f);
 	floats[REWARD_RATE_DAMAGE_DONE] = getGlobalFloat(L, "rewardRateDamageDone", 1.0f);
@@ -327,6 +339,8 @@ bool ConfigManager::load()
 	}
 	expStages.shrink_to_fit();
 
+	g_dispatcher.getProfiler().setEnabled(boolean[DISPATCHER_PROFILER], integer[DISPATCHER_PROFILER_INTERVAL]);
+
 	loaded = true;
 	lua_close(L);
 
@@ -64,6 +64,14 @@ class ConfigManager
 			HEALTH_REGEN_NOTIFICATION,
 			MANA_REGEN_NOTIFICATION,
 			AUTO_OPEN_CONTAINERS,
+			SCHEDULER_TIMER_WHEEL,
+			DISPATCHER_PROFILER,
+			PARALLEL_CREATURE_THINK,
+			MAP_LEAF_GRID,
+			PARALLEL_MAP_LOADING,
+			FLOW_FIELD_PATHING,
+			ASYNC_PATHFINDING,
+			HIERARCHICAL_PATHFINDING,
 
 			LAST_BOOLEAN_CONFIG /* this must be the last one */
 		};
@@ -141,6 +149,10 @@ class ConfigManager
 			PARTY_EXP_SHARE_FLOORS,
 			MAXIMUM_PARTY_SIZE,
 			MAXIMUM_INVITE_COUNT,
+			DISPATCHER_PROFILER_INTERVAL,
+			PARALLEL_CREATURE_THINK_THREADS,
+			ASYNC_PATHFINDING_THREADS,
+			NETWORK_THREADS,
 
 			LAST_INTEGER_CONFIG /* this must be the last one */
 		};
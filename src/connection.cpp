@@ -60,7 +60,7 @@ void Connection::close(bool force)
 		g_dispatcher.addTask(createTask([protocol = protocol]() { protocol->release(); }));
 	}
 
-	if (messageQueue.empty() || force) {
+	if ((writeBatch.empty() && messageQueue.empty()) || force) {
 		closeSocket();
 	} else {
 		//will be closed by the destructor or onWriteOperation
@@ -224,24 +224,46 @@ void Connection::send(const OutputMessage_ptr& msg)
 		return;
 	}
 
-	bool noPendingWrite = messageQueue.empty();
 	messageQueue.emplace_back(msg);
-	if (noPendingWrite) {
-		internalSend(msg);
+	if (writeBatch.empty() && !writeScheduled) {
+		// messages are encrypted on the network thread, not on the one sending them
+		writeScheduled = true;
+		boost::asio::post(socket.get_executor(), [thisPtr = shared_from_this()]() { thisPtr->startWrite(); });
 	}
 }
 
-void Connection::internalSend(const OutputMessage_ptr& msg)
+void Connection::startWrite()
 {
-	protocol->onSendMessage(msg);
+	std::lock_guard<std::recursive_mutex> lockClass(connectionLock);
+	writeScheduled = false;
+	if (!writeBatch.empty()) {
+		return;
+	}
+
+	if (!socket.is_open()) {
+		messageQueue.clear();
+	} else if (!messageQueue.empty()) {
+		internalSend();
+	} else if (closed) {
+		closeSocket();
+	}
+}
+
+void Connection::internalSend()
+{
+	writeBatch.swap(messageQueue);
+	for (const auto& message : writeBatch) {
+		protocol->onSendMessage(message);
+		writeBuffers.emplace_back(message->getOutputBuffer(), message->getLength());
+	}
+
 	try {
 		writeTimer.expires_after
 		(std::chrono::seconds(CONNECTION_WRITE_TIMEOUT));
 		writeTimer.async_wait([thisPtr = std::weak_ptr<Connection>(shared_from_this())](const boost::system::error_code& error) { Connection::handleTimeout(thisPtr, error); });
 
-		boost::asio::async_write(socket,
-		                         boost::asio::buffer(msg->getOutputBuffer(), msg->getLength()),
-								[thisPtr = shared_from_this()](const boost::system::error_code& error, auto /*bytes_transferred*/) { thisPtr->onWriteOperation(error); });
+		boost::asio::async_write(socket, writeBuffers,
+								[thisPtr = shared_from_this()](const boost::system::error_code& error, size_t bytesTransferred) { thisPtr->onWriteOperation(error, bytesTransferred); });
 	} catch (boost::system::system_error& e) {
 		std::cout << "[Network error - Connection::internalSend] " << e.what() << std::endl;
 		close(FORCE_CLOSE);
@@ -262,14 +284,21 @@ uint32_t Connection::getIP()
 	return htonl(endpoint.address().to_v4().to_uint());
 }
 
-void Connection::onWriteOperation(const boost::system::error_code& error)
+void Connection::onWriteOperation(const boost::system::error_code& error, const size_t bytesTransferred)
 {
 	std::lock_guard<std::recursive_mutex> lockClass(connectionLock);
 	writeTimer.cancel();
-    OutputMessage_ptr msg = messageQueue.front();
-	messageQueue.pop_front();
 
-	msg->reset();
+	ConnectionWriteStats& stats = ConnectionManager::getInstance().getWriteStats();
+	stats.writes.fetch_add(1, std::memory_order_relaxed);
+	stats.messages.fetch_add(writeBatch.size(), std::memory_order_relaxed);
+	stats.bytes.fetch_add(bytesTransferred, std::memory_order_relaxed);
+
+	for (const auto& message : writeBatch) {
+		message->reset();
+	}
+	writeBatch.clear();
+	writeBuffers.clear();
 
 	if (error) {
 		messageQueue.clear();
@@ -278,7 +307,7 @@ void Connection::onWriteOperation(const boost::system::error_code& error)
 	}
 
 	if (!messageQueue.empty()) {
-		internalSend(messageQueue.front());
+		internalSend();
 	} else if (closed) {
 		closeSocket();
 	}
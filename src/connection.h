@@ -4,6 +4,7 @@
 #ifndef FS_CONNECTION_H
 #define FS_CONNECTION_H
 
+#include <atomic>
 #include <unordered_set>
 #include <gtl/phmap.hpp>
 #include "networkmessage.h"
@@ -24,6 +25,13 @@ class ServicePort;
 using ServicePort_ptr = std::shared_ptr<ServicePort>;
 using ConstServicePort_ptr = std::shared_ptr<const ServicePort>;
 
+// totals over every connection, each write sends all messages queued since the previous one
+struct ConnectionWriteStats {
+	std::atomic<uint64_t> writes{0};
+	std::atomic<uint64_t> messages{0};
+	std::atomic<uint64_t> bytes{0};
+};
+
 class ConnectionManager
 {
 	public:
@@ -36,11 +44,16 @@ class ConnectionManager
 		void releaseConnection(const Connection_ptr& connection);
 		void closeAll();
 
+		ConnectionWriteStats& getWriteStats() {
+			return writeStats;
+		}
+
 	private:
 		ConnectionManager() = default;
 
 		gtl::parallel_flat_hash_set<Connection_ptr> connections;
 		std::mutex connectionManagerLock;
+		ConnectionWriteStats writeStats;
 };
 
 class Connection : public std::enable_shared_from_this<Connection>
@@ -76,12 +89,14 @@ class Connection : public std::enable_shared_from_this<Connection>
 		void parseHeader(const boost::system::error_code& error);
 		void parsePacket(const boost::system::error_code& error);
 
-		void onWriteOperation(const boost::system::error_code& error);
+		void onWriteOperation(const boost::system::error_code& error, size_t bytesTransferred);
 
 		static void handleTimeout(ConnectionWeak_ptr connectionWeak, const boost::system::error_code& error);
 
 		void closeSocket();
-		void internalSend(const OutputMessage_ptr& msg);
+		void startWrite();
+		// writes every queued message with one gather write
+		void internalSend();
 
 		boost::asio::ip::tcp::socket& getSocket() {
 			return socket;
@@ -95,7 +110,9 @@ class Connection : public std::enable_shared_from_this<Connection>
 
 		std::recursive_mutex connectionLock;
 
-		std::list<OutputMessage_ptr> messageQueue;
+		std::vector<OutputMessage_ptr> messageQueue; // waiting for the write in progress
+		std::vector<OutputMessage_ptr> writeBatch; // being written
+		std::vector<boost::asio::const_buffer> writeBuffers;
 
 		ConstServicePort_ptr service_port;
 		Protocol_ptr protocol;
@@ -106,6 +123,7 @@ class Connection : public std::enable_shared_from_this<Connection>
 		uint32_t packetsSent = 0;
 
 		bool closed = false;
+		bool writeScheduled = false;
 		bool receivedFirst = false;
 };
 
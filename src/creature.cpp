@@ -119,12 +119,6 @@ int32_t Creature::getWalkDelay() const
 
 void Creature::onThink(uint32_t interval)
 {
-	if (not isMapLoaded and useCacheMap()) 
-	{
-		isMapLoaded = true;
-		updateMapCache();
-	}
-
 	const auto& my_master = getMaster();
 
 	if (const auto& followTarget = getFollowCreature()) 
@@ -317,7 +311,7 @@ void Creature::addEventWalk(bool firstStep)
 		g_game.checkCreatureWalk(getID());
 	}
 
-	eventWalk = g_scheduler.addEvent(createSchedulerTask(ticks, [id = getID()]() { g_game.checkCreatureWalk(id); }));
+	eventWalk = g_scheduler.addEvent(createSchedulerTask("Game::checkCreatureWalk", ticks, [id = getID()]() { g_game.checkCreatureWalk(id); }));
 }
 
 void Creature::stopEventWalk()
@@ -328,38 +322,6 @@ void Creature::stopEventWalk()
 	}
 }
 
-void Creature::updateMapCache()
-{
-	const Position& myPos = getPosition();
-	Position pos(0, 0, myPos.z);
-
-	for (int32_t y = -maxWalkCacheHeight; y <= maxWalkCacheHeight; ++y) {
-		for (int32_t x = -maxWalkCacheWidth; x <= maxWalkCacheWidth; ++x) {
-			pos.x = myPos.getX() + x;
-			pos.y = myPos.getY() + y;
-			TilePtr tile = g_game.map.getTile(pos);
-			updateTileCache(tile, pos);
-		}
-	}
-}
-
-void Creature::updateTileCache(TilePtr tile, int32_t dx, int32_t dy)
-{
-	if (std::abs(dx) <= maxWalkCacheWidth && std::abs(dy) <= maxWalkCacheHeight) {
-		localMapCache[maxWalkCacheHeight + dy][maxWalkCacheWidth + dx] = tile && tile->queryAdd(getCreature(), FLAG_PATHFINDING | FLAG_IGNOREFIELDDAMAGE) == RETURNVALUE_NOERROR;
-	}
-}
-
-void Creature::updateTileCache(TilePtr tile, const Position& pos)
-{
-	const Position& myPos = getPosition();
-	if (pos.z == myPos.z) {
-		int32_t dx = Position::getOffsetX(pos, myPos);
-		int32_t dy = Position::getOffsetY(pos, myPos);
-		updateTileCache(tile, dx, dy);
-	}
-}
-
 int32_t Creature::getWalkCache(const Position& pos) const
 {
 	if (!useCacheMap()) {
@@ -374,87 +336,21 @@ int32_t Creature::getWalkCache(const Position& pos) const
 	if (pos == myPos) {
 		return 1;
 	}
-
-	int32_t dx = Position::getOffsetX(pos, myPos);
-	if (std::abs(dx) <= maxWalkCacheWidth) {
-		int32_t dy = Position::getOffsetY(pos, myPos);
-		if (std::abs(dy) <= maxWalkCacheHeight) {
-			if (localMapCache[maxWalkCacheHeight + dy][maxWalkCacheWidth + dx]) {
-				return 1;
-			} else {
-				return 0;
-			}
-		}
-	}
-
-	//out of range
-	return 2;
-}
-
-void Creature::onAddTileItem(TilePtr tile, const Position& pos)
-{
-	if (isMapLoaded && pos.z == getPosition().z) {
-		updateTileCache(tile, pos);
-	}
-}
-
-void Creature::onUpdateTileItem(const TilePtr& tile,
-								const Position& pos,
-								const ItemPtr&,
-                                const ItemType& oldType,
-                                const ItemPtr&,
-                                const ItemType& newType)
-{
-	if (!isMapLoaded) {
-		return;
-	}
-
-	if (oldType.blockSolid || oldType.blockPathFind || newType.blockPathFind || newType.blockSolid) {
-		if (pos.z == getPosition().z) {
-			updateTileCache(tile, pos);
-		}
-	}
-}
-
-void Creature::onRemoveTileItem(const TilePtr& tile, const Position& pos, const ItemType& iType, const ItemPtr&)
-{
-	if (!isMapLoaded) {
-		return;
-	}
-
-	if (iType.blockSolid || iType.blockPathFind || iType.isGroundTile()) {
-		if (pos.z == getPosition().z) {
-			updateTileCache(tile, pos);
-		}
-	}
+	return g_game.map.getWalkCache(pos, getMovementClass());
 }
 
 void Creature::onCreatureAppear(const CreaturePtr& creature, bool isLogin)
 {
 	if (creature == shared_from_this()) {
-		if (useCacheMap()) {
-			isMapLoaded = true;
-			updateMapCache();
-		}
-
 		if (isLogin) {
 			setLastPosition(getPosition());
 		}
-	} else if (isMapLoaded) {
-		if (creature->getPosition().z == getPosition().z) {
-			updateTileCache(creature->getTile(), creature->getPosition());
-		}
 	}
 }
 
 void Creature::onRemoveCreature(const CreaturePtr& creature, bool)
 {
 	onCreatureDisappear(creature, true);
-	if (creature != shared_from_this() && isMapLoaded) {
-		if (creature->getPosition().z == getPosition().z) {
-			updateTileCache(creature->getTile(), creature->getPosition());
-		}
-	}
 }
 
 void Creature::onCreatureDisappear(const CreatureConstPtr& creature, bool isLogout)
@@ -527,101 +423,6 @@ void Creature::onCreatureMove(const CreaturePtr& creature,
 		if (newTile->getZone() != oldTile->getZone()) {
 			onChangeZone(getZone());
 		}
-
-		//update map cache
-		if (isMapLoaded) {
-			if (teleport || oldPos.z != newPos.z) {
-				updateMapCache();
-			} else {
-				const Position& myPos = getPosition();
-
-				if (oldPos.y > newPos.y) { //north
-					//shift y south
-					for (int32_t y = mapWalkHeight - 1; --y >= 0;) {
-						memcpy(localMapCache[y + 1], localMapCache[y], sizeof(localMapCache[y]));
-					}
-
-					//update 0
-					for (int32_t x = -maxWalkCacheWidth; x <= maxWalkCacheWidth; ++x) {
-						auto cacheTile = g_game.map.getTile(myPos.getX() + x, myPos.getY() - maxWalkCacheHeight, myPos.z);
-						updateTileCache(cacheTile, x, -maxWalkCacheHeight);
-					}
-				} else if (oldPos.y < newPos.y) { // south
-					//shift y north
-					for (int32_t y = 0; y <= mapWalkHeight - 2; ++y) {
-						memcpy(localMapCache[y], localMapCache[y + 1], sizeof(localMapCache[y]));
-					}
-
-					//update mapWalkHeight - 1
-					for (int32_t x = -maxWalkCacheWidth; x <= maxWalkCacheWidth; ++x) {
-						auto cacheTile = g_game.map.getTile(myPos.getX() + x, myPos.getY() + maxWalkCacheHeight, myPos.z);
-						updateTileCache(cacheTile, x, maxWalkCacheHeight);
-					}
-				}
-
-				if (oldPos.x < newPos.x) { // east
-					//shift y west
-					int32_t starty = 0;
-					int32_t endy = mapWalkHeight - 1;
-					int32_t dy = Position::getDistanceY(oldPos, newPos);
-
-					if (dy < 0) {
-						endy += dy;
-					} else if (dy > 0) {
-						starty = dy;
-					}
-
-					for (int32_t y = starty; y <= endy; ++y) {
-						for (int32_t x = 0; x <= mapWalkWidth - 2; ++x) {
-							localMapCache[y][x] = localMapCache[y][x + 1];
-						}
-					}
-
-					//update mapWalkWidth - 1
-					for (int32_t y = -maxWalkCacheHeight; y <= maxWalkCacheHeight; ++y) {
-						auto cacheTile = g_game.map.getTile(myPos.x + maxWalkCacheWidth, myPos.y + y, myPos.z);
-						updateTileCache(cacheTile, maxWalkCacheWidth, y);
-					}
-				} else if (oldPos.x > newPos.x) { // west
-					//shift y east
-					int32_t starty = 0;
-					int32_t endy = mapWalkHeight - 1;
-					int32_t dy = Position::getDistanceY(oldPos, newPos);
-
-					if (dy < 0) {
-						endy += dy;
-					} else if (dy > 0) {
-						starty = dy;
-					}
-
-					for (int32_t y = starty; y <= endy; ++y) {
-						for (int32_t x = mapWalkWidth - 1; --x >= 0;) {
-							localMapCache[y][x + 1] = localMapCache[y][x];
-						}
-					}
-
-					//update 0
-					for (int32_t y = -maxWalkCacheHeight; y <= maxWalkCacheHeight; ++y) {
-						auto cacheTile = g_game.map.getTile(myPos.x - maxWalkCacheWidth, myPos.y + y, myPos.z);
-						updateTileCache(cacheTile, -maxWalkCacheWidth, y);
-					}
-				}
-
-				updateTileCache(oldTile, oldPos);
-			}
-		}
-	} else {
-		if (isMapLoaded) {
-			const Position& myPos = getPosition();
-
-			if (newPos.z == myPos.z) {
-				updateTileCache(newTile, newPos);
-			}
-
-			if (oldPos.z == myPos.z) {
-				updateTileCache(oldTile, oldPos);
-			}
-		}
 	}
 
 	if (auto target = getFollowCreature()) {
@@ -988,7 +789,15 @@ void Creature::goToFollowCreature()
 			}
 		} else {
 			listWalkDir.clear();
-			if (getPathTo(targetPos, listWalkDir, fpp)) {
+			bool found;
+			CreaturePtr self = getCreature();
+			if (canUseFlowField(fpp) && g_game.map.getFlowFieldPath(self, target, listWalkDir)) {
+				found = true;
+			} else if (!takePreparedFollowPath(target, fpp, found)) {
+				found = getPathTo(targetPos, listWalkDir, fpp);
+			}
+
+			if (found) {
 				hasFollowPath = true;
 				startAutoWalk();
 			} else {
@@ -1000,6 +809,82 @@ void Creature::goToFollowCreature()
 	onFollowCreatureComplete(getFollowCreature());
 }
 
+bool Creature::isFollowPathDue(uint32_t interval) const
+{
+	if (!getFollowCreature()) {
+		return false;
+	}
+
+	return isUpdatingPath || forceUpdateFollowPath || walkUpdateTicks + interval >= 2000;
+}
+
+void Creature::prepareFollowPath()
+{
+	// runs on a worker while the dispatcher waits, so it may only read game state
+	preparedFollowPath.ready = false;
+
+	const auto& target = getFollowCreature();
+	if (!target) {
+		return;
+	}
+
+	FindPathParams fpp;
+	getPathSearchParams(target, fpp);
+
+	// fleeing and distance keeping monsters pick their steps without A*
+	if (const auto& monster = getMonster(); monster && !monster->getMaster() && (monster->isFleeing() || fpp.maxTargetDist > 1)) {
+		return;
+	}
+
+	// the flow field is built on the dispatcher, it answers before any search is needed
+	if (canUseFlowField(fpp)) {
+		return;
+	}
+
+	// only the A* part of getPathTo, its hierarchical fallback updates the path graph and
+	// is left to the dispatcher in takePreparedFollowPath
+	preparedFollowPath.dirList.clear();
+	CreaturePtr self = getCreature();
+	preparedFollowPath.found = g_game.map.getPathMatching(self, preparedFollowPath.dirList, FrozenPathingConditionCall(target->getPosition()), fpp);
+	preparedFollowPath.fpp = fpp;
+	preparedFollowPath.startPos = getPosition();
+	preparedFollowPath.targetPos = target->getPosition();
+	preparedFollowPath.targetId = target->getID();
+	preparedFollowPath.ready = true;
+}
+
+bool Creature::takePreparedFollowPath(const CreaturePtr& target, const FindPathParams& fpp, bool& found)
+{
+	if (!preparedFollowPath.ready) {
+		return false;
+	}
+	preparedFollowPath.ready = false;
+
+	// anything that moved since the search makes the path stale
+	if (preparedFollowPath.targetId != target->getID() || preparedFollowPath.fpp != fpp ||
+			preparedFollowPath.startPos != getPosition() || preparedFollowPath.targetPos != target->getPosition()) {
+		return false;
+	}
+
+	found = preparedFollowPath.found;
+	if (found) {
+		listWalkDir.swap(preparedFollowPath.dirList);
+	} else {
+		CreaturePtr self = getCreature();
+		found = g_game.map.getHierarchicalPath(self, target->getPosition(), listWalkDir, fpp);
+	}
+	return true;
+}
+
+bool Creature::canUseFlowField(const FindPathParams& fpp) const
+{
+	// only monsters chasing into melee range share a field, anything else searches on its own
+	if (!g_config.getBoolean(ConfigManager::FLOW_FIELD_PATHING) || !getMonster()) {
+		return false;
+	}
+	return fpp.maxTargetDist == 1 && fpp.minTargetDist <= 1 && fpp.allowDiagonal && !fpp.keepDistance;
+}
+
 bool Creature::setFollowCreature(const CreaturePtr& creature)
 {
 	if (creature) {
@@ -1219,7 +1104,7 @@ bool Creature::addCondition(Condition* condition, bool force/* = false*/)
 	if (!force && condition->getType() == CONDITION_HASTE && hasCondition(CONDITION_PARALYZE)) {
 		int64_t walkDelay = getWalkDelay();
 		if (walkDelay > 0) {
-			g_scheduler.addEvent(createSchedulerTask(walkDelay, [=, id = getID()]() { g_game.forceAddCondition(id, condition); }));
+			g_scheduler.addEvent(createSchedulerTask("Game::forceAddCondition", walkDelay, [=, id = getID()]() { g_game.forceAddCondition(id, condition); }));
 			return false;
 		}
 	}
@@ -1308,7 +1193,7 @@ void Creature::removeCondition(ConditionType_t type, bool force/* = false*/)
 		if (!force && type == CONDITION_PARALYZE) {
 			int64_t walkDelay = getWalkDelay();
 			if (walkDelay > 0) {
-				g_scheduler.addEvent(createSchedulerTask(walkDelay, [=, id = getID()]() { g_game.forceRemoveCondition(id, type); }));
+				g_scheduler.addEvent(createSchedulerTask("Game::forceRemoveCondition", walkDelay, [=, id = getID()]() { g_game.forceRemoveCondition(id, type); }));
 				return;
 			}
 		}
@@ -1335,7 +1220,7 @@ void Creature::removeCondition(ConditionType_t type, ConditionId_t conditionId,
 		if (!force && type == CONDITION_PARALYZE) {
 			int64_t walkDelay = getWalkDelay();
 			if (walkDelay > 0) {
-				g_scheduler.addEvent(createSchedulerTask(walkDelay, [=, id = getID()]() { g_game.forceRemoveCondition(id, type); }));
+				g_scheduler.addEvent(createSchedulerTask("Game::forceRemoveCondition", walkDelay, [=, id = getID()]() { g_game.forceRemoveCondition(id, type); }));
 				return;
 			}
 		}
@@ -1373,7 +1258,7 @@ void Creature::removeCondition(Condition* condition, bool force/* = false*/)
 	if (!force && condition->getType() == CONDITION_PARALYZE) {
 		int64_t walkDelay = getWalkDelay();
 		if (walkDelay > 0) {
-			g_scheduler.addEvent(createSchedulerTask(walkDelay, [id = getID(), type = condition->getType()]() { g_game.forceRemoveCondition(id, type); }));
+			g_scheduler.addEvent(createSchedulerTask("Game::forceRemoveCondition", walkDelay, [id = getID(), type = condition->getType()]() { g_game.forceRemoveCondition(id, type); }));
 			return;
 		}
 	}
@@ -1722,14 +1607,13 @@ bool FrozenPathingConditionCall::isInRange(const Position& startPos, const Posit
 bool FrozenPathingConditionCall::operator()(const Position& startPos, const Position& testPos,
         const FindPathParams& fpp, int32_t& bestMatchDist) const
 {
-	if (!isInRange(startPos, testPos, fpp)) {
-		return false;
-	}
-
-	if (fpp.clearSight && !g_game.isSightClear(testPos, targetPos, true)) {
-		return false;
-	}
+	return (*this)(startPos, testPos, fpp, bestMatchDist, [](const Position& fromPos, const Position& toPos) {
+		return g_game.map.isSightClearCached(fromPos, toPos, true);
+	});
+}
 
+bool FrozenPathingConditionCall::isTargetDistance(const Position& testPos, const FindPathParams& fpp, int32_t& bestMatchDist) const
+{
 	int32_t testDist = std::max<int32_t>(Position::getDistanceX(targetPos, testPos), Position::getDistanceY(targetPos, testPos));
 	if (fpp.maxTargetDist == 1) {
 		if (testDist < fpp.minTargetDist || testDist > fpp.maxTargetDist) {
@@ -1764,7 +1648,12 @@ bool Creature::isInvisible() const
 bool Creature::getPathTo(const Position& targetPos, std::vector<Direction>& dirList, const FindPathParams& fpp)
 {
 	CreaturePtr t_c = getCreature();
-	return g_game.map.getPathMatching(t_c, dirList, FrozenPathingConditionCall(targetPos), fpp);
+	if (g_game.map.getPathMatching(t_c, dirList, FrozenPathingConditionCall(targetPos), fpp)) {
+		return true;
+	}
+
+	// the node budget runs out long before far away targets
+	return g_game.map.getHierarchicalPath(t_c, targetPos, dirList, fpp);
 }
 
 bool Creature::getPathTo(const Position& targetPos, std::vector<Direction>& dirList, int32_t minTargetDist, int32_t maxTargetDist, bool fullPathSearch /*= true*/, bool clearSight /*= true*/, int32_t maxSearchDist /*= 0*/)
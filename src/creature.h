@@ -47,6 +47,8 @@ struct FindPathParams {
 	int32_t maxSearchDist = 0;
 	int32_t minTargetDist = -1;
 	int32_t maxTargetDist = -1;
+
+	bool operator==(const FindPathParams&) const = default;
 };
 static constexpr int32_t EVENT_DUMP_DECAY = 250;
 static constexpr int32_t EVENT_CREATURE_THINK_INTERVAL = 1000;
@@ -61,10 +63,26 @@ class FrozenPathingConditionCall
 		bool operator()(const Position& startPos, const Position& testPos,
 		                const FindPathParams& fpp, int32_t& bestMatchDist) const;
 
+		// the same test with line of sight answered by the caller, for searches that don't read the map
+		template <typename SightCheck>
+		bool operator()(const Position& startPos, const Position& testPos,
+		                const FindPathParams& fpp, int32_t& bestMatchDist, const SightCheck& isSightClear) const {
+			if (!isInRange(startPos, testPos, fpp)) {
+				return false;
+			}
+
+			if (fpp.clearSight && !isSightClear(testPos, targetPos)) {
+				return false;
+			}
+			return isTargetDistance(testPos, fpp, bestMatchDist);
+		}
+
 		bool isInRange(const Position& startPos, const Position& testPos,
 		               const FindPathParams& fpp) const;
 
 	private:
+		bool isTargetDistance(const Position& testPos, const FindPathParams& fpp, int32_t& bestMatchDist) const;
+
 		Position targetPos;
 };
 
@@ -304,6 +322,13 @@ class Creature : virtual public Thing, public SharedObject
 		void stopEventWalk();
 		virtual void goToFollowCreature();
 
+		// the parallel think cycle searches the follow path ahead of onThink, on a worker thread
+		bool isFollowPathDue(uint32_t interval) const;
+		void prepareFollowPath();
+		void discardPreparedFollowPath() {
+			preparedFollowPath.ready = false;
+		}
+
 		//walk events
 		virtual void onWalk(Direction& dir);
 		virtual void onWalkAborted() {}
@@ -453,11 +478,11 @@ class Creature : virtual public Thing, public SharedObject
 		virtual void onWalk();
 		virtual bool getNextStep(Direction& dir, uint32_t& flags);
 
-		void onAddTileItem(TilePtr tile, const Position& pos);
-		virtual void onUpdateTileItem(const TilePtr& tile, const Position& pos, const ItemPtr& oldItem,
-		                              const ItemType& oldType, const ItemPtr& newItem, const ItemType& newType);
-		virtual void onRemoveTileItem(const TilePtr& tile, const Position& pos, const ItemType& iType,
-		                              const ItemPtr& item);
+		// tiles only notify the player spectators of item changes
+		virtual void onUpdateTileItem(const TilePtr&, const Position&, const ItemPtr&,
+		                              const ItemType&, const ItemPtr&, const ItemType&) {}
+		virtual void onRemoveTileItem(const TilePtr&, const Position&, const ItemType&,
+		                              const ItemPtr&) {}
 
 		virtual void onCreatureAppear(const CreaturePtr& creature, bool isLogin);
 		virtual void onRemoveCreature(const CreaturePtr& creature, bool isLogout);
@@ -644,16 +669,16 @@ class Creature : virtual public Thing, public SharedObject
 			return false;
 		}
 
+		// selects the shared passability layer getWalkCache reads
+		virtual uint8_t getMovementClass() const {
+			return MOVEMENTCLASS_NONE;
+		}
+
 		struct CountBlock_t {
 			int32_t total;
 			int64_t ticks;
 		};
 
-		static constexpr int32_t mapWalkWidth = Map::maxViewportX * 2 + 1;
-		static constexpr int32_t mapWalkHeight = Map::maxViewportY * 2 + 1;
-		static constexpr int32_t maxWalkCacheWidth = (mapWalkWidth - 1) / 2;
-		static constexpr int32_t maxWalkCacheHeight = (mapWalkHeight - 1) / 2;
-
 		Position position;
 
 		using CountMap = std::map<uint32_t, CountBlock_t>;
@@ -697,9 +722,7 @@ class Creature : virtual public Thing, public SharedObject
 		Direction direction = DIRECTION_SOUTH;
 		Skulls_t skull = SKULL_NONE;
 
-		bool localMapCache[mapWalkHeight][mapWalkWidth] = {{ false }};
 		bool isInternalRemoved = false;
-		bool isMapLoaded = false;
 		bool isUpdatingPath = false;
 		bool creatureCheck = false;
 		bool inCheckCreaturesVector = false;
@@ -712,6 +735,19 @@ class Creature : virtual public Thing, public SharedObject
 		bool canUseDefense = true;
 		bool movementBlocked = false;
 
+		struct PreparedFollowPath
+		{
+			std::vector<Direction> dirList;
+			FindPathParams fpp;
+			Position startPos;
+			Position targetPos;
+			uint32_t targetId = 0;
+			bool found = false;
+			bool ready = false;
+		};
+
+		PreparedFollowPath preparedFollowPath;
+
 		//creature script events
 		bool hasEventRegistered(CreatureEventType_t event) const {
 			return (0 != (scriptEventsBitField & (static_cast<uint32_t>(1) << event)));
@@ -719,9 +755,8 @@ class Creature : virtual public Thing, public SharedObject
 	
 		CreatureEventList getCreatureEvents(CreatureEventType_t type) const;
 
-		void updateMapCache();
-		void updateTileCache(TilePtr tile, int32_t dx, int32_t dy);
-		void updateTileCache(TilePtr tile, const Position& pos);
+		bool takePreparedFollowPath(const CreaturePtr& target, const FindPathParams& fpp, bool& found);
+		bool canUseFlowField(const FindPathParams& fpp) const;
 		void onCreatureDisappear(const CreatureConstPtr& creature, bool isLogout);
 		virtual void doAttacking(uint32_t) {}
 	
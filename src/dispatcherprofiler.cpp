@@ -0,0 +1,155 @@
+// Copyright 2024 Black Tek Server Authors. All rights reserved.
+// Use of this source code is governed by the GPL-2.0 License that can be found in the LICENSE file.
+
+#include "otpch.h"
+
+#include "dispatcherprofiler.h"
+
+#include <bit>
+#include <fstream>
+#include <fmt/chrono.h>
+#include <fmt/format.h>
+
+uint32_t LatencyHistogram::getBucket(uint64_t value)
+{
+	if (value < SUB_BUCKETS) {
+		return static_cast<uint32_t>(value);
+	}
+
+	const uint32_t shift = std::bit_width(value) - 1 - SUB_BUCKET_BITS;
+	return ((shift + 1) << SUB_BUCKET_BITS) + static_cast<uint32_t>((value >> shift) & (SUB_BUCKETS - 1));
+}
+
+uint64_t LatencyHistogram::getBucketValue(uint32_t bucket)
+{
+	if (bucket < SUB_BUCKETS) {
+		return bucket;
+	}
+
+	const uint32_t shift = (bucket >> SUB_BUCKET_BITS) - 1;
+	return static_cast<uint64_t>(SUB_BUCKETS + (bucket & (SUB_BUCKETS - 1))) << shift;
+}
+
+void LatencyHistogram::record(uint64_t micros)
+{
+	++buckets[getBucket(micros)];
+	++count;
+	total += micros;
+	max = std::max(max, micros);
+}
+
+void LatencyHistogram::reset()
+{
+	buckets.fill(0);
+	count = 0;
+	total = 0;
+	max = 0;
+}
+
+uint64_t LatencyHistogram::getPercentile(double percentile) const
+{
+	if (count == 0) {
+		return 0;
+	}
+
+	const uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(count * percentile / 100.0)));
+	uint64_t seen = 0;
+	for (uint32_t bucket = 0; bucket < BUCKETS; ++bucket) {
+		seen += buckets[bucket];
+		if (seen >= target) {
+			// report the highest value that falls into the bucket
+			if (bucket + 1 == BUCKETS) {
+				return max;
+			}
+			return std::min(getBucketValue(bucket + 1) - 1, max);
+		}
+	}
+	return max;
+}
+
+void DispatcherProfiler::setEnabled(bool enabled, uint32_t dumpIntervalMs)
+{
+	dumpInterval.store(std::max<uint32_t>(1000, dumpIntervalMs), std::memory_order_relaxed);
+	this->enabled.store(enabled, std::memory_order_relaxed);
+}
+
+DispatcherProfiler::TagStats& DispatcherProfiler::getStats(const char* tag)
+{
+	return stats[tag ? tag : "untagged"];
+}
+
+void DispatcherProfiler::record(const char* tag, int64_t queuedAt, int64_t startedAt, int64_t finishedAt)
+{
+	TagStats& tagStats = getStats(tag);
+	// tasks queued before the profiler was enabled have no queue timestamp
+	if (queuedAt != 0) {
+		tagStats.wait.record(std::max<int64_t>(0, startedAt - queuedAt));
+	}
+	tagStats.execution.record(std::max<int64_t>(0, finishedAt - startedAt));
+}
+
+void DispatcherProfiler::recordScope(const char* tag, int64_t startedAt, int64_t finishedAt)
+{
+	getStats(tag).execution.record(std::max<int64_t>(0, finishedAt - startedAt));
+}
+
+void DispatcherProfiler::dumpIfDue(int64_t now)
+{
+	if (lastDump == 0) {
+		lastDump = now;
+		return;
+	}
+
+	if (now - lastDump >= static_cast<int64_t>(dumpInterval.load(std::memory_order_relaxed)) * 1000) {
+		dump(now);
+		lastDump = now;
+	}
+}
+
+void DispatcherProfiler::dump(int64_t now)
+{
+	writeLog(now);
+
+	// every dump covers one interval
+	for (auto& it : stats) {
+		it.second.wait.reset();
+		it.second.execution.reset();
+	}
+}
+
+void DispatcherProfiler::writeLog(int64_t now) const
+{
+	std::vector<std::pair<std::string_view, const TagStats*>> sorted;
+	sorted.reserve(stats.size());
+	for (const auto& it : stats) {
+		if (it.second.execution.getCount() != 0) {
+			sorted.emplace_back(it.first, &it.second);
+		}
+	}
+
+	if (sorted.empty()) {
+		return;
+	}
+
+	// the tags that cost the dispatcher the most time come first
+	std::sort(sorted.begin(), sorted.end(), [](const auto& lhs, const auto& rhs) {
+		return lhs.second->execution.getTotal() > rhs.second->execution.getTotal();
+	});
+
+	std::ofstream file("data/logs/dispatcher_profile.log", std::ios::app);
+	if (!file.is_open()) {
+		std::cout << "[Warning - DispatcherProfiler::dump] Unable to open data/logs/dispatcher_profile.log" << std::endl;
+		return;
+	}
+
+	file << fmt::format("[{:%Y-%m-%d %H:%M:%S}] dispatcher profile over the last {:d} ms (times in us)\n", fmt::localtime(std::time(nullptr)), (now - lastDump) / 1000);
+	file << fmt::format("{:<40} {:>9} {:>8} {:>8} {:>9} {:>8} {:>8} {:>9} {:>11}\n", "tag", "count", "wait p50", "wait p99", "wait max", "exec p50", "exec p99", "exec max", "exec total");
+	for (const auto& [tag, tagStats] : sorted) {
+		const LatencyHistogram& wait = tagStats->wait;
+		const LatencyHistogram& execution = tagStats->execution;
+		file << fmt::format("{:<40} {:>9} {:>8} {:>8} {:>9} {:>8} {:>8} {:>9} {:>11}\n", tag, execution.getCount(),
+			wait.getPercentile(50), wait.getPercentile(99), wait.getMax(),
+			execution.getPercentile(50), execution.getPercentile(99), execution.getMax(), execution.getTotal());
+	}
+	file << std::endl;
+}
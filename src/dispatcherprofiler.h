@@ -0,0 +1,111 @@
+// Copyright 2024 Black Tek Server Authors. All rights reserved.
+// Use of this source code is governed by the GPL-2.0 License that can be found in the LICENSE file.
+
+#ifndef FS_DISPATCHERPROFILER_H
+#define FS_DISPATCHERPROFILER_H
+
+#include <array>
+#include <atomic>
+#include <gtl/phmap.hpp>
+
+// Log-linear (HDR style) histogram of microsecond latencies: every power of two
+// is split in 16 sub buckets, so any recorded value is known within ~6%.
+class LatencyHistogram
+{
+	public:
+		void record(uint64_t micros);
+		void reset();
+
+		uint64_t getPercentile(double percentile) const;
+
+		uint64_t getCount() const {
+			return count;
+		}
+
+		uint64_t getMax() const {
+			return max;
+		}
+
+		uint64_t getTotal() const {
+			return total;
+		}
+
+	private:
+		static constexpr uint32_t SUB_BUCKET_BITS = 4;
+		static constexpr uint32_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+		static constexpr uint32_t BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+		static uint32_t getBucket(uint64_t value);
+		static uint64_t getBucketValue(uint32_t bucket);
+
+		std::array<uint64_t, BUCKETS> buckets = {};
+		uint64_t count = 0;
+		uint64_t total = 0;
+		uint64_t max = 0;
+};
+
+// Collects queue-wait and execution latencies per task tag for one dispatcher.
+// Recording only happens on the owning dispatcher thread, enabling is the only
+// thing other threads touch.
+class DispatcherProfiler
+{
+	public:
+		class Scope;
+
+		void setEnabled(bool enabled, uint32_t dumpIntervalMs);
+
+		bool isEnabled() const {
+			return enabled.load(std::memory_order_relaxed);
+		}
+
+		void record(const char* tag, int64_t queuedAt, int64_t startedAt, int64_t finishedAt);
+		void recordScope(const char* tag, int64_t startedAt, int64_t finishedAt);
+
+		// writes p50/p99/max per tag to the profile log once the dump interval elapsed
+		void dumpIfDue(int64_t now);
+
+		static int64_t now() {
+			return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+	private:
+		struct TagStats
+		{
+			LatencyHistogram wait;
+			LatencyHistogram execution;
+		};
+
+		TagStats& getStats(const char* tag);
+		void dump(int64_t now);
+		void writeLog(int64_t now) const;
+
+		gtl::node_hash_map<std::string_view, TagStats> stats;
+		std::atomic<bool> enabled{false};
+		std::atomic<uint32_t> dumpInterval{60000};
+		int64_t lastDump = 0;
+};
+
+// times a section inside a task (e.g. the creature think cycle) under its own tag
+class DispatcherProfiler::Scope
+{
+	public:
+		Scope(DispatcherProfiler& profiler, const char* tag) :
+			profiler(profiler), tag(tag), startedAt(profiler.isEnabled() ? DispatcherProfiler::now() : 0) {}
+
+		~Scope() {
+			if (startedAt != 0 && profiler.isEnabled()) {
+				profiler.recordScope(tag, startedAt, DispatcherProfiler::now());
+			}
+		}
+
+		// non-copyable
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+		DispatcherProfiler& profiler;
+		const char* tag;
+		int64_t startedAt;
+};
+
+#endif
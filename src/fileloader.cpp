@@ -93,6 +93,7 @@ bool Loader::getProps(const Node& node, PropStream& props)
 	if (size == 0) {
 		return false;
 	}
+	thread_local std::vector<char> propBuffer;
 	propBuffer.resize(size);
 	bool lastEscaped = false;
 
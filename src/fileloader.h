@@ -44,9 +44,9 @@ struct InvalidOTBFormat final : LoadError {
 class Loader {
 	MappedFile     fileContents;
 	Node              root;
-	std::vector<char> propBuffer;
 public:
 	Loader(const std::string& fileName, const Identifier& acceptedIdentifier);
+	// props stay valid until the next getProps call on the same thread
 	bool getProps(const Node& node, PropStream& props);
 	const Node& parseTree();
 };
@@ -65,6 +65,10 @@ class PropStream
 			return end - p;
 		}
 
+		const char* data() const {
+			return p;
+		}
+
 		template <typename T>
 		bool read(T& ret) {
 			if (size() < sizeof(T)) {
@@ -92,12 +92,15 @@ void Game::start(ServiceManager* manager)
 	updateWorldTime();
 
 	if (g_config.getBoolean(ConfigManager::DEFAULT_WORLD_LIGHT)) {
-		g_scheduler.addEvent(createSchedulerTask(EVENT_LIGHTINTERVAL, [this]() { checkLight(); }));
+		g_scheduler.addEvent(createSchedulerTask("Game::checkLight", EVENT_LIGHTINTERVAL, [this]() { checkLight(); }));
 	}
-	g_scheduler.addEvent(createSchedulerTask(20, [this]() { decay_clean_cycle(); }));
-	g_scheduler.addEvent(createSchedulerTask(50, [this]() { coro_timer_cycle(); }));
-	g_scheduler.addEvent(createSchedulerTask(100, [this]() { item_decay_cycle(); }));
-	g_scheduler.addEvent(createSchedulerTask(120, [this]() { equipment_decay_cycle(); }));
+	if (g_config.getBoolean(ConfigManager::ASYNC_PATHFINDING)) {
+		pathfinders.start(g_config.getNumber(ConfigManager::ASYNC_PATHFINDING_THREADS));
+	}
+	g_scheduler.addEvent(createSchedulerTask("Game::decay_clean_cycle", 20, [this]() { decay_clean_cycle(); }));
+	g_scheduler.addEvent(createSchedulerTask("Game::coro_timer_cycle", 50, [this]() { coro_timer_cycle(); }));
+	g_scheduler.addEvent(createSchedulerTask("Game::item_decay_cycle", 100, [this]() { item_decay_cycle(); }));
+	g_scheduler.addEvent(createSchedulerTask("Game::equipment_decay_cycle", 120, [this]() { equipment_decay_cycle(); }));
 }
 
 GameState_t Game::getGameState() const
@@ -216,7 +219,12 @@ void Game::saveGameState()
 
 bool Game::loadMainMap(const std::string& filename)
 {
+	map.setLeafGrid(g_config.getBoolean(ConfigManager::MAP_LEAF_GRID));
 	if (map.loadMap("data/world/" + filename + ".otbm", true)) {
+		if (g_config.getBoolean(ConfigManager::HIERARCHICAL_PATHFINDING)) {
+			map.buildPathGraph(g_config.getBoolean(ConfigManager::PARALLEL_MAP_LOADING));
+		}
+
 		for (auto& [id, house] : g_game.map.houses.getHouses()) {
 			for (auto& tile : house->getTiles()) {
 				if (auto itemlist = tile->getItemList()) {
@@ -597,7 +605,7 @@ bool Game::placeCreature(CreaturePtr creature, const Position& pos, bool extende
 		spectator->onCreatureAppear(creature, true);
 		if (const auto& monster = spectator->getMonster()) 
 		{
-			monster->setIdle(false);
+			monster->wakeUpBy(creature);
 		}
 	}
 
@@ -705,7 +713,7 @@ void Game::playerMoveThing(const uint32_t playerId, const Position& fromPos,
 		}
 
 		if (Position::areInRange<1, 1, 0>(movingCreature->getPosition(), player->getPosition()) && !player->isAccessPlayer() ) {
-			SchedulerTask* task = createSchedulerTask(MOVE_CREATURE_INTERVAL, [=, this, playerID = player->getID(), creatureID = movingCreature->getID()]() {
+			SchedulerTask* task = createSchedulerTask("Game::playerMoveCreatureByID", MOVE_CREATURE_INTERVAL, [=, this, playerID = player->getID(), creatureID = movingCreature->getID()]() {
 				playerMoveCreatureByID(playerID, creatureID, fromPos, toPos);
 				});
 			player->setNextActionTask(task);
@@ -748,7 +756,7 @@ void Game::playerMoveCreature(PlayerPtr& player, CreaturePtr& movingCreature, co
 {
 	if (!player->canDoAction() && !player->isAccessPlayer()) {
 		uint32_t delay = player->getNextActionTime();
-		SchedulerTask* task = createSchedulerTask(delay,
+		SchedulerTask* task = createSchedulerTask("Game::playerMoveCreatureByID", delay,
 			[=, this, playerID = player->getID(), movingCreatureID = movingCreature->getID(), toPos = toTile->getPosition()]() {
 				playerMoveCreatureByID(playerID, movingCreatureID, movingCreatureOrigPos, toPos);
 			});
@@ -778,17 +786,11 @@ void Game::playerMoveCreature(PlayerPtr& player, CreaturePtr& movingCreature, co
 
 	if (!Position::areInRange<1, 1, 0>(movingCreatureOrigPos, player->getPosition())) {
 		//need to walk to the creature first before moving it
-		std::vector<Direction> listDir;
-		if (player->getPathTo(movingCreatureOrigPos, listDir, 0, 1, true, true)) {
-			g_dispatcher.addTask(createTask([=, this, playerID = player->getID(), listDir = std::move(listDir)]() { playerAutoWalk(playerID, listDir); }));
-			SchedulerTask* task = createSchedulerTask(RANGE_MOVE_CREATURE_INTERVAL,
-				[=, this, playerID = player->getID(), movingCreatureID = movingCreature->getID(), toPos = toTile->getPosition()] {
-					playerMoveCreatureByID(playerID, movingCreatureID, movingCreatureOrigPos, toPos);
-				});
-			player->setNextWalkActionTask(task);
-		} else {
-			player->sendCancelMessage(RETURNVALUE_THEREISNOWAY);
-		}
+		SchedulerTask* task = createSchedulerTask("Game::playerMoveCreatureByID", RANGE_MOVE_CREATURE_INTERVAL,
+			[=, this, playerID = player->getID(), movingCreatureID = movingCreature->getID(), toPos = toTile->getPosition()] {
+				playerMoveCreatureByID(playerID, movingCreatureID, movingCreatureOrigPos, toPos);
+			});
+		playerWalkToAndDo(player, movingCreatureOrigPos, 1, task);
 		return;
 	}
 
@@ -970,7 +972,7 @@ void Game::playerMoveItem(const PlayerPtr& player,
 {
 	if (!player->canDoAction() && !player->isAccessPlayer()) {
 		uint32_t delay = player->getNextActionTime();
-		SchedulerTask* task = createSchedulerTask(delay, [=, this, playerID = player->getID()]() {
+		SchedulerTask* task = createSchedulerTask("Game::playerMoveItemByPlayerID", delay, [=, this, playerID = player->getID()]() {
 			playerMoveItemByPlayerID(playerID, fromPos, spriteId, fromStackPos, toPos, count);
 			});
 		player->setNextActionTask(task);
@@ -1047,16 +1049,10 @@ void Game::playerMoveItem(const PlayerPtr& player,
 
 	if (!Position::areInRange<1, 1>(playerPos, mapFromPos)) {
 		//need to walk to the item first before using it
-		std::vector<Direction> listDir;
-		if (player->getPathTo(item->getPosition(), listDir, 0, 1, true, true)) {
-			g_dispatcher.addTask(createTask([=, this, playerID = player->getID(), listDir = std::move(listDir)]() { playerAutoWalk(playerID, listDir); })); // suspect lamba
-			SchedulerTask* task = createSchedulerTask(RANGE_MOVE_ITEM_INTERVAL, [=, this, playerID = player->getID()]() {
-				playerMoveItemByPlayerID(playerID, fromPos, spriteId, fromStackPos, toPos, count);
-				});
-			player->setNextWalkActionTask(task);
-		} else {
-			player->sendCancelMessage(RETURNVALUE_THEREISNOWAY);
-		}
+		SchedulerTask* task = createSchedulerTask("Game::playerMoveItemByPlayerID", RANGE_MOVE_ITEM_INTERVAL, [=, this, playerID = player->getID()]() {
+			playerMoveItemByPlayerID(playerID, fromPos, spriteId, fromStackPos, toPos, count);
+			});
+		playerWalkToAndDo(player, item->getPosition(), 1, task);
 		return;
 	}
 
@@ -1105,17 +1101,11 @@ void Game::playerMoveItem(const PlayerPtr& player,
 				internalGetPosition(moveItem, itemPos, itemStackPos);
 			}
 
-			std::vector<Direction> listDir;
-			if (player->getPathTo(walkPos, listDir, 0, 0, true, true)) {
-				g_dispatcher.addTask(createTask([=, this, playerID = player->getID(), listDir = std::move(listDir)]() { playerAutoWalk(playerID, listDir); }));
-				SchedulerTask* task = createSchedulerTask(RANGE_MOVE_ITEM_INTERVAL,
-					[this, playerID = player->getID(), itemPos, spriteId, itemStackPos, toPos, count]() {
-						playerMoveItemByPlayerID(playerID, itemPos, spriteId, itemStackPos, toPos, count);
-					});
-				player->setNextWalkActionTask(task);
-			} else {
-				player->sendCancelMessage(RETURNVALUE_THEREISNOWAY);
-			}
+			SchedulerTask* task = createSchedulerTask("Game::playerMoveItemByPlayerID", RANGE_MOVE_ITEM_INTERVAL,
+				[this, playerID = player->getID(), itemPos, spriteId, itemStackPos, toPos, count]() {
+					playerMoveItemByPlayerID(playerID, itemPos, spriteId, itemStackPos, toPos, count);
+				});
+			playerWalkToAndDo(player, walkPos, 0, task);
 			return;
 		}
 	}
@@ -2201,6 +2191,30 @@ void Game::playerAutoWalk(const uint32_t playerId, const std::vector<Direction>&
 	player->startAutoWalk(listDir);
 }
 
+void Game::playerWalkToAndDo(const PlayerPtr& player, const Position& pos, const int32_t maxTargetDist, SchedulerTask* task)
+{
+	FindPathParams fpp;
+	fpp.minTargetDist = 0;
+	fpp.maxTargetDist = maxTargetDist;
+
+	pathfinders.findPath(player, pos, fpp, PathRequestKind::WALK, [this, task](const CreaturePtr& creature, const bool found, std::vector<Direction>& listDir) {
+		const auto& player = creature ? creature->getPlayer() : nullptr;
+		if (!player) {
+			delete task;
+			return;
+		}
+
+		if (!found) {
+			delete task;
+			player->sendCancelMessage(RETURNVALUE_THEREISNOWAY);
+			return;
+		}
+
+		g_dispatcher.addTask(createTask([this, playerID = player->getID(), listDir = std::move(listDir)]() { playerAutoWalk(playerID, listDir); }));
+		player->setNextWalkActionTask(task);
+	});
+}
+
 void Game::playerStopAutoWalk(const uint32_t playerId)
 {
 	const auto player = getPlayerByID(playerId);
@@ -2272,16 +2286,10 @@ void Game::playerUseItemEx(const uint32_t playerId, const Position& fromPos, con
 				internalGetPosition(moveItem, itemPos, itemStackPos);
 			}
 
-			std::vector<Direction> listDir;
-			if (player->getPathTo(walkToPos, listDir, 0, 1, true, true)) {
-				g_dispatcher.addTask(createTask([=, this, playerID = player->getID(), listDir = std::move(listDir)]() { playerAutoWalk(playerID, listDir); }));
-				SchedulerTask* task = createSchedulerTask(RANGE_USE_ITEM_EX_INTERVAL, [=, this]() {
-					playerUseItemEx(playerId, itemPos, itemStackPos, fromSpriteId, toPos, toStackPos, toSpriteId);
-					});
-				player->setNextWalkActionTask(task);
-			} else {
-				player->sendCancelMessage(RETURNVALUE_THEREISNOWAY);
-			}
+			SchedulerTask* task = createSchedulerTask("Game::playerUseItemEx", RANGE_USE_ITEM_EX_INTERVAL, [=, this]() {
+				playerUseItemEx(playerId, itemPos, itemStackPos, fromSpriteId, toPos, toStackPos, toSpriteId);
+				});
+			playerWalkToAndDo(player, walkToPos, 1, task);
 			return;
 		}
 
@@ -2291,7 +2299,7 @@ void Game::playerUseItemEx(const uint32_t playerId, const Position& fromPos, con
 
 	if (!player->canDoAction()) {
 		const uint32_t delay = player->getNextActionTime();
-		SchedulerTask* task = createSchedulerTask(delay, [=, this]() {
+		SchedulerTask* task = createSchedulerTask("Game::playerUseItemEx", delay, [=, this]() {
 			playerUseItemEx(playerId, fromPos, fromStackPos, fromSpriteId, toPos, toStackPos, toSpriteId);
 			});
 		player->setNextActionTask(task);
@@ -2331,14 +2339,9 @@ void Game::playerUseItem(const uint32_t playerId, const Position& pos, const uin
 
 	if (ReturnValue ret = g_actions->canUse(player, pos); ret != RETURNVALUE_NOERROR) {
 		if (ret == RETURNVALUE_TOOFARAWAY) {
-			if (std::vector<Direction> listDir; player->getPathTo(pos, listDir, 0, 1, true, true)) {
-				g_dispatcher.addTask(createTask([this, playerID = player->getID(), listDir = std::move(listDir)]() { playerAutoWalk(playerID, listDir); }));
-				SchedulerTask* task = createSchedulerTask(RANGE_USE_ITEM_INTERVAL, [=, this]() { playerUseItem(playerId, pos, stackPos, index, spriteId); });
-				player->setNextWalkActionTask(task);
-				return;
-			}
-
-			ret = RETURNVALUE_THEREISNOWAY;
+			SchedulerTask* task = createSchedulerTask("Game::playerUseItem", RANGE_USE_ITEM_INTERVAL, [=, this]() { playerUseItem(playerId, pos, stackPos, index, spriteId); });
+			playerWalkToAndDo(player, pos, 1, task);
+			return;
 		}
 
 		player->sendCancelMessage(ret);
@@ -2347,7 +2350,7 @@ void Game::playerUseItem(const uint32_t playerId, const Position& pos, const uin
 
 	if (!player->canDoAction()) {
 		const uint32_t delay = player->getNextActionTime();
-		SchedulerTask* task = createSchedulerTask(delay, [=, this]() { playerUseItem(playerId, pos, stackPos, index, spriteId); });
+		SchedulerTask* task = createSchedulerTask("Game::playerUseItem", delay, [=, this]() { playerUseItem(playerId, pos, stackPos, index, spriteId); });
 		player->setNextActionTask(task);
 		return;
 	}
@@ -2424,15 +2427,10 @@ void Game::playerUseWithCreature(const uint32_t playerId, const Position& fromPo
 				internalGetPosition(moveItem, itemPos, itemStackPos);
 			}
 
-			if (std::vector<Direction> listDir; player->getPathTo(walkToPos, listDir, 0, 1, true, true)) {
-				g_dispatcher.addTask(createTask([this, playerID = player->getID(), listDir = std::move(listDir)]() { playerAutoWalk(playerID, listDir); }));
-				SchedulerTask* task = createSchedulerTask(RANGE_USE_WITH_CREATURE_INTERVAL, [=, this]() {
-					playerUseWithCreature(playerId, itemPos, itemStackPos, creatureId, spriteId);
-					});
-				player->setNextWalkActionTask(task);
-			} else {
-				player->sendCancelMessage(RETURNVALUE_THEREISNOWAY);
-			}
+			SchedulerTask* task = createSchedulerTask("Game::playerUseWithCreature", RANGE_USE_WITH_CREATURE_INTERVAL, [=, this]() {
+				playerUseWithCreature(playerId, itemPos, itemStackPos, creatureId, spriteId);
+				});
+			playerWalkToAndDo(player, walkToPos, 1, task);
 			return;
 		}
 
@@ -2442,7 +2440,7 @@ void Game::playerUseWithCreature(const uint32_t playerId, const Position& fromPo
 
 	if (!player->canDoAction()) {
 		const uint32_t delay = player->getNextActionTime();
-		SchedulerTask* task = createSchedulerTask(delay, [=, this]() { playerUseWithCreature(playerId, fromPos, fromStackPos, creatureId, spriteId); });
+		SchedulerTask* task = createSchedulerTask("Game::playerUseWithCreature", delay, [=, this]() { playerUseWithCreature(playerId, fromPos, fromStackPos, creatureId, spriteId); });
 		player->setNextActionTask(task);
 		return;
 	}
@@ -2534,13 +2532,8 @@ void Game::playerRotateItem(const uint32_t playerId, const Position& pos, const
 	}
 
 	if (pos.x != 0xFFFF && !Position::areInRange<1, 1, 0>(pos, player->getPosition())) {
-		if (std::vector<Direction> listDir; player->getPathTo(pos, listDir, 0, 1, true, true)) {
-			g_dispatcher.addTask(createTask([this, playerID = player->getID(), listDir = std::move(listDir)]() { playerAutoWalk(playerID, listDir); }));
-			SchedulerTask* task = createSchedulerTask(RANGE_ROTATE_ITEM_INTERVAL, [=, this]() { playerRotateItem(playerId, pos, stackPos, spriteId); });
-			player->setNextWalkActionTask(task);
-		} else {
-			player->sendCancelMessage(RETURNVALUE_THEREISNOWAY);
-		}
+		SchedulerTask* task = createSchedulerTask("Game::playerRotateItem", RANGE_ROTATE_ITEM_INTERVAL, [=, this]() { playerRotateItem(playerId, pos, stackPos, spriteId); });
+		playerWalkToAndDo(player, pos, 1, task);
 		return;
 	}
 
@@ -2622,13 +2615,8 @@ void Game::playerBrowseField(const uint32_t playerId, const Position& pos)
 	}
 
 	if (!Position::areInRange<1, 1>(playerPos, pos)) {
-		if (std::vector<Direction> listDir; player->getPathTo(pos, listDir, 0, 1, true, true)) {
-			g_dispatcher.addTask(createTask([this, playerID = player->getID(), listDir = std::move(listDir)]() { playerAutoWalk(playerID, listDir); }));
-			SchedulerTask* task = createSchedulerTask(RANGE_BROWSE_FIELD_INTERVAL, [=, this]() { playerBrowseField(playerId, pos); });
-			player->setNextWalkActionTask(task);
-		} else {
-			player->sendCancelMessage(RETURNVALUE_THEREISNOWAY);
-		}
+		SchedulerTask* task = createSchedulerTask("Game::playerBrowseField", RANGE_BROWSE_FIELD_INTERVAL, [=, this]() { playerBrowseField(playerId, pos); });
+		playerWalkToAndDo(player, pos, 1, task);
 		return;
 	}
 
@@ -2718,13 +2706,8 @@ void Game::playerWrapItem(const uint32_t playerId, const Position& position, con
 	}
 
 	if (position.x != 0xFFFF && !Position::areInRange<1, 1, 0>(position, player->getPosition())) {
-		if (std::vector<Direction> listDir; player->getPathTo(position, listDir, 0, 1, true, true)) {
-			g_dispatcher.addTask(createTask([this, playerID = player->getID(), listDir = std::move(listDir)]() { playerAutoWalk(playerID, listDir); }));
-			const auto task = createSchedulerTask(RANGE_WRAP_ITEM_INTERVAL, [=, this]() { playerWrapItem(playerId, position, stackPos, spriteId); });
-			player->setNextWalkActionTask(task);
-		} else {
-			player->sendCancelMessage(RETURNVALUE_THEREISNOWAY);
-		}
+		SchedulerTask* task = createSchedulerTask("Game::playerWrapItem", RANGE_WRAP_ITEM_INTERVAL, [=, this]() { playerWrapItem(playerId, position, stackPos, spriteId); });
+		playerWalkToAndDo(player, position, 1, task);
 		return;
 	}
 
@@ -2784,15 +2767,10 @@ void Game::playerRequestTrade(const uint32_t playerId, const Position& pos, uint
 	}
 
 	if (!Position::areInRange<1, 1>(tradeItemPosition, playerPosition)) {
-		if (std::vector<Direction> listDir; player->getPathTo(pos, listDir, 0, 1, true, true)) {
-			g_dispatcher.addTask(createTask([this, playerID = player->getID(), listDir = std::move(listDir)]() { playerAutoWalk(playerID, listDir); }));
-			const auto task = createSchedulerTask(RANGE_REQUEST_TRADE_INTERVAL, [=, this]() {
-				playerRequestTrade(playerId, pos, stackPos, tradePlayerId, spriteId);
-				});
-			player->setNextWalkActionTask(task);
-		} else {
-			player->sendCancelMessage(RETURNVALUE_THEREISNOWAY);
-		}
+		SchedulerTask* task = createSchedulerTask("Game::playerRequestTrade", RANGE_REQUEST_TRADE_INTERVAL, [=, this]() {
+			playerRequestTrade(playerId, pos, stackPos, tradePlayerId, spriteId);
+			});
+		playerWalkToAndDo(player, pos, 1, task);
 		return;
 	}
 
@@ -4819,11 +4797,18 @@ bool Game::internalCreatureSay(const CreaturePtr& creature, const SpeakClasses t
 		spectators = (*spectatorsPtr);
 	}
 
-	//send to client
+	//send to client, the message is the same for everyone who may hear it
+	PacketBuffer packet;
+	ProtocolGame::AddCreatureSay(packet, creature, type, text, pos);
 	for (const auto& spectator : spectators) {
 		if (const auto& tmpPlayer = spectator->getPlayer()) {
 			if (!ghostMode || tmpPlayer->canSeeCreature(creature)) {
-				tmpPlayer->sendCreatureSay(creature, type, text, pos);
+				// texts too long for the small buffer are encoded for each player
+				if (packet.isOverrun()) {
+					tmpPlayer->sendCreatureSay(creature, type, text, pos);
+				} else {
+					tmpPlayer->sendPacket(packet);
+				}
 			}
 		}
 	}
@@ -4869,6 +4854,20 @@ void Game::checkCreatureAttack(const uint32_t creatureId) noexcept
 
 
 
+void Game::onMonsterIdleChanged(const Monster& monster)
+{
+	// monsters not yet (or no longer) registered are accounted for by addMonster/removeMonster
+	if (!monsters.contains(monster.getID())) {
+		return;
+	}
+
+	if (monster.getIdleStatus()) {
+		++monstersHibernated;
+	} else {
+		--monstersHibernated;
+	}
+}
+
 void Game::addCreatureCheck(const CreaturePtr& creature) noexcept
 {
     auto c_check = creature->creatureCheck;
@@ -4904,12 +4903,19 @@ void Game::removeCreatureCheck(const CreaturePtr& creature) noexcept
 
 void Game::creature_think_cycle() noexcept
 {
+    DispatcherProfiler::Scope profile(g_dispatcher.getProfiler(), "Game::creature_think_cycle");
     auto& checkCreatureList = slots_[current_slot_];
     current_slot_ = (current_slot_ + 1) % 20;
+    map.advanceSightTick();
 auto valid_creatures = checkCreatureList 
         | std::views::filter([](const auto& creature) { return creature->creatureCheck; })
         | std::views::filter([](const auto& creature) { return creature->getHealth() > 0; });
 
+    if (g_config.getBoolean(ConfigManager::PARALLEL_CREATURE_THINK))
+    {
+        prepareFollowPaths(checkCreatureList);
+    }
+
     for (auto& creature : valid_creatures)
     {
         creature->onThink(1000);
@@ -4917,6 +4923,13 @@ auto valid_creatures = checkCreatureList
         creature->executeConditions(1000);
     }
 
+    // a path that was not picked up during this cycle could be stale by the next one
+    for (const auto& creature : followPathBatch)
+    {
+        creature->discardPreparedFollowPath();
+    }
+    followPathBatch.clear();
+
     std::erase_if(checkCreatureList, [](const auto& creature) 
 	{
         if (not creature->creatureCheck) 
@@ -4928,6 +4941,51 @@ auto valid_creatures = checkCreatureList
     });
 }
 
+void Game::prepareFollowPaths(const std::list<CreaturePtr>& creatures)
+{
+	DispatcherProfiler::Scope profile(g_dispatcher.getProfiler(), "Game::prepareFollowPaths");
+
+	for (const auto& creature : creatures) {
+		if (creature->creatureCheck && creature->getHealth() > 0 && creature->isFollowPathDue(EVENT_CREATURE_THINK_INTERVAL)) {
+			followPathBatch.push_back(creature);
+		}
+	}
+
+	if (followPathBatch.size() < MinParallelFollowPaths) {
+		followPathBatch.clear();
+		return;
+	}
+
+	if (!thinkWorkers.isRunning()) {
+		thinkWorkers.start(g_config.getNumber(ConfigManager::PARALLEL_CREATURE_THINK_THREADS));
+	}
+
+	// one job per map leaf (8x8 tiles), nearby creatures search the same tiles
+	const auto regionKey = [](const CreaturePtr& creature) {
+		const Position& pos = creature->getPosition();
+		return (static_cast<uint64_t>(pos.z) << 32) | (static_cast<uint64_t>(pos.y >> FLOOR_BITS) << 16) | (pos.x >> FLOOR_BITS);
+	};
+	std::stable_sort(followPathBatch.begin(), followPathBatch.end(), [&](const CreaturePtr& lhs, const CreaturePtr& rhs) {
+		return regionKey(lhs) < regionKey(rhs);
+	});
+
+	std::vector<size_t> regions;
+	for (size_t i = 0; i < followPathBatch.size(); ++i) {
+		if (i == 0 || regionKey(followPathBatch[i]) != regionKey(followPathBatch[i - 1])) {
+			regions.push_back(i);
+		}
+	}
+	regions.push_back(followPathBatch.size());
+
+	// the dispatcher blocks until every search is done, nothing can change the map meanwhile;
+	// the paths are applied by goToFollowCreature in the usual think order
+	thinkWorkers.parallelFor(regions.size() - 1, [&](size_t region) {
+		for (size_t i = regions[region]; i < regions[region + 1]; ++i) {
+			followPathBatch[i]->prepareFollowPath();
+		}
+	});
+}
+
 void Game::changeSpeed(const CreaturePtr& creature, const int32_t varSpeedDelta)
 {
 	int32_t varSpeed = creature->getSpeed() - creature->getBaseSpeed();
@@ -5733,9 +5791,12 @@ void Game::addCreatureHealth(const CreatureConstPtr& target)
 
 void Game::addCreatureHealth(const SpectatorVec& spectators, const CreatureConstPtr& target)
 {
-	for (const auto spectator : spectators) {
+	// encoded once, every spectator only gets the bytes copied
+	PacketBuffer packet;
+	ProtocolGame::AddCreatureHealth(packet, target);
+	for (const auto& spectator : spectators) {
 		if (const auto tmpPlayer = spectator->getPlayer()) {
-			tmpPlayer->sendCreatureHealth(target);
+			tmpPlayer->sendPacket(packet);
 		}
 	}
 }
@@ -5749,9 +5810,11 @@ void Game::addMagicEffect(const Position& pos, const uint8_t effect)
 
 void Game::addMagicEffect(const SpectatorVec& spectators, const Position& pos, const uint8_t effect)
 {
-	for (const auto spectator : spectators) {
+	PacketBuffer packet;
+	ProtocolGame::AddMagicEffect(packet, pos, effect);
+	for (const auto& spectator : spectators) {
 		if (const auto tmpPlayer = spectator->getPlayer()) {
-			tmpPlayer->sendMagicEffect(pos, effect);
+			tmpPlayer->sendMagicEffect(packet, pos);
 		}
 	}
 }
@@ -5768,9 +5831,11 @@ void Game::addDistanceEffect(const Position& fromPos, const Position& toPos, con
 
 void Game::addDistanceEffect(const SpectatorVec& spectators, const Position& fromPos, const Position& toPos, uint8_t effect)
 {
-	for (const auto spectator : spectators) {
+	PacketBuffer packet;
+	ProtocolGame::AddDistanceShoot(packet, fromPos, toPos, effect);
+	for (const auto& spectator : spectators) {
 		if (const auto tmpPlayer = spectator->getPlayer()) {
-			tmpPlayer->sendDistanceShoot(fromPos, toPos, effect);
+			tmpPlayer->sendPacket(packet);
 		}
 	}
 }
@@ -5966,7 +6031,7 @@ CoroTask Game::item_decay_cycle() noexcept
 
 void Game::checkLight()
 {
-	g_scheduler.addEvent(createSchedulerTask(EVENT_LIGHTINTERVAL, [=, this]() { checkLight(); }));
+	g_scheduler.addEvent(createSchedulerTask("Game::checkLight", EVENT_LIGHTINTERVAL, [=, this]() { checkLight(); }));
 	uint8_t previousLightLevel = lightLevel;
 	updateWorldLightLevel();
 	
@@ -5994,7 +6059,7 @@ void Game::updateWorldLightLevel()
 
 void Game::updateWorldTime()
 {
-	g_scheduler.addEvent(createSchedulerTask(EVENT_WORLDTIMEINTERVAL, [=, this]() { updateWorldTime(); }));
+	g_scheduler.addEvent(createSchedulerTask("Game::updateWorldTime", EVENT_WORLDTIMEINTERVAL, [=, this]() { updateWorldTime(); }));
 	const time_t osTime = time(nullptr);
 	const auto timeInfo = localtime(&osTime);
 	worldTime = (timeInfo->tm_sec + (timeInfo->tm_min * 60)) / 2.5f;
@@ -6029,6 +6094,8 @@ void Game::shutdown()
 	g_databaseTasks.shutdown();
 	g_dispatcher.shutdown();
 	g_utility_boss.shutdown();
+	thinkWorkers.shutdown();
+	pathfinders.shutdown();
 	map.spawns.clear();
 	raids.clear();
 
@@ -6045,7 +6112,7 @@ void Game::shutdown()
 
 void Game::coro_timer_cycle()
 {
-	g_scheduler.addEvent(createSchedulerTask(EVENT_CORO_TIMER_CYCLE, [this]() { coro_timer_cycle(); }));
+	g_scheduler.addEvent(createSchedulerTask("Game::coro_timer_cycle", EVENT_CORO_TIMER_CYCLE, [this]() { coro_timer_cycle(); }));
     creature_think_cycle();
 	g_timer_queue.tick();
 }
@@ -6064,7 +6131,7 @@ void Game::decay_clean_cycle()
 
 	equipped_decay_precache.clear();
     map_decay_precache.clear();
-	g_scheduler.addEvent(createSchedulerTask(EVENT_DUMP_DECAY, [this]() { decay_clean_cycle(); }));
+	g_scheduler.addEvent(createSchedulerTask("Game::decay_clean_cycle", EVENT_DUMP_DECAY, [this]() { decay_clean_cycle(); }));
 }
 
 void Game::broadcastMessage(const std::string& text, const MessageClasses type) const
@@ -7008,12 +7075,23 @@ void Game::removeNpc(const NpcPtr& npc)
 
 void Game::addMonster(MonsterPtr monster)
 {
-	monsters[monster->getID()] = monster;
+	const bool idle = monster->getIdleStatus();
+	if (monsters.try_emplace(monster->getID(), std::move(monster)).second && idle) {
+		++monstersHibernated;
+	}
 }
 
 void Game::removeMonster(const MonsterPtr& monster)
 {
-	monsters.erase(monster->getID());
+	auto it = monsters.find(monster->getID());
+	if (it == monsters.end()) {
+		return;
+	}
+
+	if (it->second->getIdleStatus()) {
+		--monstersHibernated;
+	}
+	monsters.erase(it);
 }
 
 void Game::internalRemoveItems(const std::vector<ItemPtr>& itemList, uint32_t amount, const bool stackable)
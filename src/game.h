@@ -18,6 +18,8 @@
 #include "npc.h"
 #include "wildcardtree.h"
 #include "quests.h"
+#include "workerpool.h"
+#include "pathfinding.h"
 
 #include <gtl/phmap.hpp>
 
@@ -77,6 +79,8 @@ static constexpr int32_t RANGE_REQUEST_TRADE_INTERVAL = 400;
 static constexpr uint32_t EquipmentDecayMaxInterval = 100;
 static constexpr uint32_t MapDecayMaxInterval = 250;
 static constexpr size_t MaxCreatureThinkSlots = 20;
+// below this many path searches per think cycle waking the workers costs more than it saves
+static constexpr size_t MinParallelFollowPaths = 16;
 
 #include <coroutine>
 #include <chrono>
@@ -343,6 +347,7 @@ class Game
         static void removeCreatureCheck(const CreaturePtr& creature) noexcept;
 
         void creature_think_cycle() noexcept;
+		void prepareFollowPaths(const std::list<CreaturePtr>& creatures);
 
         void addEquippedItemDecay(Expirable entry) noexcept;
 		void addMapItemDecay(Expirable entry) noexcept;
@@ -358,6 +363,10 @@ class Game
 		size_t getMonstersOnline() const {
 			return monsters.size();
 		}
+		size_t getMonstersHibernated() const {
+			return monstersHibernated;
+		}
+		void onMonsterIdleChanged(const Monster& monster);
 
 		size_t getNpcsOnline() const {
 			return npcs.size();
@@ -502,6 +511,8 @@ class Game
 		void playerReceivePing(uint32_t playerId);
 		void playerReceivePingBack(uint32_t playerId);
 		void playerAutoWalk(uint32_t playerId, const std::vector<Direction>& listDir);
+		// walks the player next to pos and runs task once there, the path may be searched off the dispatcher
+		void playerWalkToAndDo(const PlayerPtr& player, const Position& pos, int32_t maxTargetDist, SchedulerTask* task);
 		void playerStopAutoWalk(uint32_t playerId);
 		void playerUseItemEx(uint32_t playerId, const Position& fromPos, uint8_t fromStackPos,
 		                     uint16_t fromSpriteId, const Position& toPos, uint8_t toStackPos, uint16_t toSpriteId);
@@ -660,6 +671,7 @@ class Game
 		Mounts mounts;
 		Raids raids;
 		Quests quests;
+		PathfindingPool pathfinders;
 
 		std::deque<Expirable> equipped_decay_precache;
 		std::deque<Expirable> map_decay_precache;
@@ -743,6 +755,9 @@ class Game
 		std::array<std::list<CreaturePtr>, MaxCreatureThinkSlots> slots_;
         size_t current_slot_ = 0;
 
+		WorkerPool thinkWorkers;
+		std::vector<CreaturePtr> followPathBatch;
+
 		std::list<ItemPtr> decayItems[EVENT_DECAY_BUCKETS];
 		std::vector<TilePtr> loaded_tiles;
 		std::vector<ItemPtr> loaded_tile_items;
@@ -756,6 +771,7 @@ class Game
 
 		std::map<uint32_t, NpcPtr> npcs;
 		std::map<uint32_t, MonsterPtr> monsters;
+		size_t monstersHibernated = 0;
 
 		//list of items that are in trading state, mapped to the player
 		std::map<ItemPtr, uint32_t> tradeItems;
@@ -70,7 +70,7 @@ bool GlobalEvents::registerEvent(Event_ptr event, const pugi::xml_node&)
 		auto result = timerMap.emplace(globalEvent->getName(), std::move(*globalEvent));
 		if (result.second) {
 			if (timerEventId == 0) {
-				timerEventId = g_scheduler.addEvent(createSchedulerTask(SCHEDULER_MINTICKS, [this]() { timer(); }));
+				timerEventId = g_scheduler.addEvent(createSchedulerTask("GlobalEvents::timer", SCHEDULER_MINTICKS, [this]() { timer(); }));
 			}
 			return true;
 		}
@@ -83,7 +83,7 @@ bool GlobalEvents::registerEvent(Event_ptr event, const pugi::xml_node&)
 		auto result = thinkMap.emplace(globalEvent->getName(), std::move(*globalEvent));
 		if (result.second) {
 			if (thinkEventId == 0) {
-				thinkEventId = g_scheduler.addEvent(createSchedulerTask(SCHEDULER_MINTICKS, [this]() { think(); }));
+				thinkEventId = g_scheduler.addEvent(createSchedulerTask("GlobalEvents::think", SCHEDULER_MINTICKS, [this]() { think(); }));
 			}
 			return true;
 		}
@@ -100,7 +100,7 @@ bool GlobalEvents::registerLuaEvent(GlobalEvent* event)
 		auto result = timerMap.emplace(globalEvent->getName(), std::move(*globalEvent));
 		if (result.second) {
 			if (timerEventId == 0) {
-				timerEventId = g_scheduler.addEvent(createSchedulerTask(SCHEDULER_MINTICKS, [this]() { timer(); }));
+				timerEventId = g_scheduler.addEvent(createSchedulerTask("GlobalEvents::timer", SCHEDULER_MINTICKS, [this]() { timer(); }));
 			}
 			return true;
 		}
@@ -113,7 +113,7 @@ bool GlobalEvents::registerLuaEvent(GlobalEvent* event)
 		auto result = thinkMap.emplace(globalEvent->getName(), std::move(*globalEvent));
 		if (result.second) {
 			if (thinkEventId == 0) {
-				thinkEventId = g_scheduler.addEvent(createSchedulerTask(SCHEDULER_MINTICKS, [this]() { think(); }));
+				thinkEventId = g_scheduler.addEvent(createSchedulerTask("GlobalEvents::think", SCHEDULER_MINTICKS, [this]() { think(); }));
 			}
 			return true;
 		}
@@ -174,7 +174,7 @@ void GlobalEvents::timer()
 	}
 
 	if (nextScheduledTime != std::numeric_limits<int64_t>::max()) {
-		timerEventId = g_scheduler.addEvent(createSchedulerTask(std::max<int64_t>(1000, nextScheduledTime * 1000), [this]() { timer(); }));
+		timerEventId = g_scheduler.addEvent(createSchedulerTask("GlobalEvents::timer", std::max<int64_t>(1000, nextScheduledTime * 1000), [this]() { timer(); }));
 	}
 }
 
@@ -207,7 +207,7 @@ void GlobalEvents::think()
 	}
 
 	if (nextScheduledTime != std::numeric_limits<int64_t>::max()) {
-		thinkEventId = g_scheduler.addEvent(createSchedulerTask(nextScheduledTime, [this]() { think(); }));
+		thinkEventId = g_scheduler.addEvent(createSchedulerTask("GlobalEvents::think", nextScheduledTime, [this]() { think(); }));
 	}
 }
 
@@ -6,6 +6,7 @@
 #include "iomap.h"
 
 #include "bed.h"
+#include "workerpool.h"
 
 #include <fmt/format.h>
 
@@ -36,10 +37,10 @@
 TilePtr IOMap::createTile(ItemPtr& ground, uint16_t x, uint16_t y, uint8_t z)
 {
 	if (!ground) {
-		return std::make_shared<Tile>(x, y, z);
+		return TileArena::createTile(x, y, z);
 	}
 
-	TilePtr	tile = std::make_shared<Tile>(x, y, z);
+	TilePtr	tile = TileArena::createTile(x, y, z);
 
 	tile->internalAddThing(ground);
 	ground->startDecaying();
@@ -50,10 +51,14 @@ TilePtr IOMap::createTile(ItemPtr& ground, uint16_t x, uint16_t y, uint8_t z)
 bool IOMap::loadMap(Map* map, const std::filesystem::path& fileName)
 {
 	const auto start = OTSYS_TIME();
+	int64_t parseTime = 0;
+	int64_t decodeTime = 0;
+	size_t decodeThreads = 1;
 	try {
 		OTB::Loader loader{ fileName.string(), OTB::Identifier{{'O', 'T', 'B', 'M'}} };
 
 		const auto& root = loader.parseTree();
+		parseTime = OTSYS_TIME() - start;
 		PropStream propStream;
 		if (!loader.getProps(root, propStream)) {
 			setLastErrorString("Could not read root property.");
@@ -95,13 +100,41 @@ bool IOMap::loadMap(Map* map, const std::filesystem::path& fileName)
 			return false;
 		}
 
+		// tile areas don't depend on each other, decode them all up front and
+		// merge them into the map in file order so the result is the same
+		std::vector<const OTB::Node*> tileAreaNodes;
+		for (const auto& mapDataNode : mapNode.children) {
+			if (mapDataNode.type == OTBM_TILE_AREA) {
+				tileAreaNodes.push_back(&mapDataNode);
+			}
+		}
+
+		const auto decodeStart = OTSYS_TIME();
+		std::vector<TileAreaBatch> tileAreas(tileAreaNodes.size());
+		{
+			WorkerPool decoders;
+			if (g_config.getBoolean(ConfigManager::PARALLEL_MAP_LOADING)) {
+				decoders.start(0);
+			}
+			decodeThreads += decoders.getThreadCount();
+
+			decoders.parallelFor(tileAreaNodes.size(), [&](size_t i) {
+				decodeTileArea(loader, *tileAreaNodes[i], tileAreas[i]);
+			});
+		}
+		decodeTime = OTSYS_TIME() - decodeStart;
+
+		size_t tileAreaIndex = 0;
 		for (const auto& mapDataNode : mapNode.children) {
 			switch (mapDataNode.type) {
-			case OTBM_TILE_AREA:
-				[[unlikely]] if (!parseTileArea(loader, mapDataNode, *map)) {
+			case OTBM_TILE_AREA: {
+				TileAreaBatch& tileArea = tileAreas[tileAreaIndex++];
+				[[unlikely]] if (!mergeTileArea(loader, tileArea, *map)) {
 					return false;
 				}
+				tileArea = {};
 				break;
+			}
 			case OTBM_TOWNS:
 				[[unlikely]] if (!parseTowns(loader, mapDataNode, *map)) {
 					return false;
@@ -123,7 +156,20 @@ bool IOMap::loadMap(Map* map, const std::filesystem::path& fileName)
 		return false;
 	}
 
-	std::cout << "> Map loading time: " << (OTSYS_TIME() - start) / (1000.) << " seconds." << std::endl;
+	const int64_t loadTime = OTSYS_TIME() - start;
+	std::cout << "> Map loading time: " << loadTime / (1000.) << " seconds (parsing: " << parseTime / (1000.) << ", decoding: " << decodeTime / (1000.) << " on " << decodeThreads << " threads, merging: " << (loadTime - parseTime - decodeTime) / (1000.) << ")." << std::endl;
+
+	size_t tiles = 0;
+	size_t tileBytes = 0;
+	for (uint8_t z = 0; z < MAP_MAX_LAYERS; ++z) {
+		const TileArena& arena = TileArena::getFloor(z);
+		tiles += arena.getAllocations();
+		tileBytes += arena.getReservedBytes();
+	}
+
+	if (tiles != 0) {
+		std::cout << "> Map tiles: " << tiles << " in " << tileBytes / (1024 * 1024) << " MB of tile arenas (" << tileBytes / tiles << " bytes per tile)." << std::endl;
+	}
 	return true;
 }
 
@@ -174,17 +220,17 @@ bool IOMap::parseMapDataAttributes(OTB::Loader& loader, const OTB::Node& mapNode
 	return true;
 }
 
-bool IOMap::parseTileArea(OTB::Loader& loader, const OTB::Node& tileAreaNode, Map& map)
+bool IOMap::decodeTileArea(OTB::Loader& loader, const OTB::Node& tileAreaNode, TileAreaBatch& batch)
 {
 	PropStream propStream;
 	if (!loader.getProps(tileAreaNode, propStream)) {
-		setLastErrorString("Invalid map node.");
+		batch.error = "Invalid map node.";
 		return false;
 	}
 
 	OTBM_Destination_coords area_coord;
 	if (!propStream.read(area_coord)) {
-		setLastErrorString("Invalid map node.");
+		batch.error = "Invalid map node.";
 		return false;
 	}
 
@@ -192,47 +238,37 @@ bool IOMap::parseTileArea(OTB::Loader& loader, const OTB::Node& tileAreaNode, Ma
 	const uint16_t base_y = area_coord.y;
 	const uint16_t z = area_coord.z;
 
+	batch.tiles.reserve(tileAreaNode.children.size());
 	for (const auto& tileNode : tileAreaNode.children | std::views::all) {
 		if (tileNode.type != OTBM_TILE && tileNode.type != OTBM_HOUSETILE) {
-			setLastErrorString("Unknown tile node.");
+			batch.error = "Unknown tile node.";
 			return false;
 		}
 
 		if (!loader.getProps(tileNode, propStream)) {
-			setLastErrorString("Could not read node data.");
+			batch.error = "Could not read node data.";
 			return false;
 		}
 
 		OTBM_Tile_coords tile_coord;
 		if (!propStream.read(tile_coord)) {
-			setLastErrorString("Could not read tile position.");
+			batch.error = "Could not read tile position.";
 			return false;
 		}
 
-		uint16_t x = base_x + tile_coord.x;
-		uint16_t y = base_y + tile_coord.y;
+		DecodedTile tile;
+		tile.x = base_x + tile_coord.x;
+		tile.y = base_y + tile_coord.y;
+		tile.z = static_cast<uint8_t>(z);
+		tile.isHouseTile = (tileNode.type == OTBM_HOUSETILE);
+		tile.firstItem = static_cast<uint32_t>(batch.items.size());
 
-		bool isHouseTile = (tileNode.type == OTBM_HOUSETILE);
-		TilePtr tile = nullptr;
-		ItemPtr ground_item = nullptr;
-		uint32_t tileflags = TILESTATE_NONE;
-
-		if (isHouseTile) {
-			uint32_t houseId;
-			if (!propStream.read<uint32_t>(houseId)) {
-				setLastErrorString(fmt::format("[x:{:d}, y:{:d}, z:{:d}] Could not read house id.", x, y, z));
-				return false;
-			}
+		const uint16_t x = tile.x;
+		const uint16_t y = tile.y;
 
-			const auto house = map.houses.addHouse(houseId);
-			if (!house) {
-				setLastErrorString(fmt::format("[x:{:d}, y:{:d}, z:{:d}] Could not create house id: {:d}", x, y, z, houseId));
-				return false;
-			}
-			
-			auto houseTile = std::make_shared<Tile>(x, y, z, house);
-			tile = houseTile;
-			house->addTile(houseTile);
+		if (tile.isHouseTile && !propStream.read<uint32_t>(tile.houseId)) {
+			batch.error = fmt::format("[x:{:d}, y:{:d}, z:{:d}] Could not read house id.", x, y, z);
+			return false;
 		}
 
 		uint8_t attribute;
@@ -242,84 +278,143 @@ bool IOMap::parseTileArea(OTB::Loader& loader, const OTB::Node& tileAreaNode, Ma
 				case OTBM_ATTR_TILE_FLAGS: {
 					uint32_t flags;
 					if (!propStream.read<uint32_t>(flags)) {
-						setLastErrorString(fmt::format("[x:{:d}, y:{:d}, z:{:d}] Failed to read tile flags.", x, y, z));
+						batch.error = fmt::format("[x:{:d}, y:{:d}, z:{:d}] Failed to read tile flags.", x, y, z);
 						return false;
 					}
 
 					if ((flags & OTBM_TILEFLAG_PROTECTIONZONE) != 0) {
-						tileflags |= TILESTATE_PROTECTIONZONE;
+						tile.flags |= TILESTATE_PROTECTIONZONE;
 					} else if ((flags & OTBM_TILEFLAG_NOPVPZONE) != 0) {
-						tileflags |= TILESTATE_NOPVPZONE;
+						tile.flags |= TILESTATE_NOPVPZONE;
 					} else if ((flags & OTBM_TILEFLAG_PVPZONE) != 0) {
-						tileflags |= TILESTATE_PVPZONE;
+						tile.flags |= TILESTATE_PVPZONE;
 					}
 
 					if ((flags & OTBM_TILEFLAG_NOLOGOUT) != 0) {
-						tileflags |= TILESTATE_NOLOGOUT;
+						tile.flags |= TILESTATE_NOLOGOUT;
 					}
 					break;
 				}
 
 				case OTBM_ATTR_ITEM: {
-					auto item = Item::CreateItem(propStream);
-					if (!item) {
-						setLastErrorString(fmt::format("[x:{:d}, y:{:d}, z:{:d}] Failed to create item.", x, y, z));
+					if (!decodeItem(nullptr, propStream, batch)) {
+						batch.error = fmt::format("[x:{:d}, y:{:d}, z:{:d}] Failed to create item.", x, y, z);
 						return false;
 					}
-
-					if (isHouseTile && item->isMoveable()) {
-						std::cout << "[Warning - IOMap::loadMap] Moveable item with ID: " << item->getID() << ", at position [x: " << x << ", y: " << y << ", z: " << z << "]." << std::endl;;
-					} else {
-						if (item->getItemCount() == 0) {
-							item->setItemCount(1);
-						}
-
-						if (tile) {
-							tile->internalAddThing(item);
-							item->startDecaying();
-							item->setLoadedFromMap(true);
-						} else if (item->isGroundTile()) {
-							ground_item = std::move(item);
-						} else {
-							tile = createTile(ground_item, x, y, z);
-							tile->internalAddThing(item);
-							item->startDecaying();
-							item->setLoadedFromMap(true);
-						}
-					}
 					break;
 				}
 
 				default:
-					setLastErrorString(fmt::format("[x:{:d}, y:{:d}, z:{:d}] Unknown tile attribute.", x, y, z));
+					batch.error = fmt::format("[x:{:d}, y:{:d}, z:{:d}] Unknown tile attribute.", x, y, z);
 					return false;
 			}
 		}
 
 		for (const auto& itemNode : tileNode.children | std::views::all) {
 			if (itemNode.type != OTBM_ITEM) {
-				setLastErrorString(fmt::format("[x:{:d}, y:{:d}, z:{:d}] Unknown node type.", x, y, z));
+				batch.error = fmt::format("[x:{:d}, y:{:d}, z:{:d}] Unknown node type.", x, y, z);
 				return false;
 			}
 
 			PropStream stream;
 			if (!loader.getProps(itemNode, stream)) {
-				setLastErrorString("Invalid item node.");
+				batch.error = "Invalid item node.";
 				return false;
 			}
 
-			auto item = Item::CreateItem(stream);
-			if (!item) {
-				setLastErrorString(fmt::format("[x:{:d}, y:{:d}, z:{:d}] Failed to create item.", x, y, z));
+			if (!decodeItem(&itemNode, stream, batch)) {
+				batch.error = fmt::format("[x:{:d}, y:{:d}, z:{:d}] Failed to create item.", x, y, z);
+				return false;
+			}
+		}
+
+		tile.itemCount = static_cast<uint32_t>(batch.items.size()) - tile.firstItem;
+		batch.tiles.push_back(tile);
+	}
+	return true;
+}
+
+bool IOMap::decodeItem(const OTB::Node* itemNode, PropStream& propStream, TileAreaBatch& batch)
+{
+	DecodedItem decoded;
+	decoded.node = itemNode;
+
+	PropStream peekStream = propStream;
+	uint16_t id;
+	if (!peekStream.read<uint16_t>(id)) {
+		return false;
+	}
+
+	// augments given by the item type fire lua events, those items are created while merging
+	if (Item::items[id].augments.empty()) {
+		decoded.item = Item::CreateItem(propStream);
+		if (!decoded.item) {
+			return false;
+		}
+
+		if (!itemNode || (propStream.size() == 0 && itemNode->children.empty())) {
+			decoded.node = nullptr;
+			batch.items.push_back(std::move(decoded));
+			return true;
+		}
+	}
+
+	// inline tile items are just an id, item nodes keep whatever is left of their props
+	const size_t size = itemNode ? propStream.size() : sizeof(uint16_t);
+	decoded.propsOffset = static_cast<uint32_t>(batch.props.size());
+	decoded.propsSize = static_cast<uint32_t>(size);
+	batch.props.insert(batch.props.end(), propStream.data(), propStream.data() + size);
+	if (!itemNode) {
+		propStream.skip(size);
+	}
+
+	batch.items.push_back(std::move(decoded));
+	return true;
+}
+
+bool IOMap::mergeTileArea(OTB::Loader& loader, TileAreaBatch& batch, Map& map)
+{
+	for (const DecodedTile& decodedTile : batch.tiles) {
+		const uint16_t x = decodedTile.x;
+		const uint16_t y = decodedTile.y;
+		const uint16_t z = decodedTile.z;
+
+		TilePtr tile = nullptr;
+		ItemPtr ground_item = nullptr;
+
+		if (decodedTile.isHouseTile) {
+			const auto house = map.houses.addHouse(decodedTile.houseId);
+			if (!house) {
+				setLastErrorString(fmt::format("[x:{:d}, y:{:d}, z:{:d}] Could not create house id: {:d}", x, y, z, decodedTile.houseId));
 				return false;
 			}
 
-			if (!item->unserializeItemNode(loader, itemNode, stream)) {
+			auto houseTile = TileArena::createTile(x, y, z, house);
+			tile = houseTile;
+			house->addTile(houseTile);
+		}
+
+		for (uint32_t i = decodedTile.firstItem, last = decodedTile.firstItem + decodedTile.itemCount; i < last; ++i) {
+			DecodedItem& decoded = batch.items[i];
+
+			PropStream stream;
+			stream.init(batch.props.data() + decoded.propsOffset, decoded.propsSize);
+
+			ItemPtr item = std::move(decoded.item);
+			if (!item) {
+				item = Item::CreateItem(stream);
+				if (!item) {
+					setLastErrorString(fmt::format("[x:{:d}, y:{:d}, z:{:d}] Failed to create item.", x, y, z));
+					return false;
+				}
+			}
+
+			if (decoded.node && !item->unserializeItemNode(loader, *decoded.node, stream)) {
 				setLastErrorString(fmt::format("[x:{:d}, y:{:d}, z:{:d}] Failed to load item {:d}.", x, y, z, item->getID()));
 				return false;
 			}
 
-			if (isHouseTile && item->isMoveable()) {
+			if (decodedTile.isHouseTile && item->isMoveable()) {
 				std::cout << "[Warning - IOMap::loadMap] Moveable item with ID: " << item->getID() << ", at position [x: " << x << ", y: " << y << ", z: " << z << "]." << std::endl;
 			} else {
 				if (item->getItemCount() == 0) {
@@ -345,10 +440,15 @@ bool IOMap::parseTileArea(OTB::Loader& loader, const OTB::Node& tileAreaNode, Ma
 			tile = createTile(ground_item, x, y, z);
 		}
 
-		tile->setFlag(static_cast<tileflags_t>(tileflags));
+		tile->setFlag(static_cast<tileflags_t>(decodedTile.flags));
 
 		map.setTile(x, y, z, tile);
 	}
+
+	if (!batch.error.empty()) {
+		setLastErrorString(batch.error);
+		return false;
+	}
 	return true;
 }
 
@@ -132,10 +132,40 @@ class IOMap
 		}
 
 	private:
+		// an item read from a tile area, item is only created by the decoder when that
+		// has no side effects, attributes are always read while merging
+		struct DecodedItem {
+			ItemPtr item;
+			const OTB::Node* node = nullptr;
+			uint32_t propsOffset = 0;
+			uint32_t propsSize = 0;
+		};
+
+		struct DecodedTile {
+			uint32_t houseId = 0;
+			uint32_t flags = TILESTATE_NONE;
+			uint32_t firstItem = 0;
+			uint32_t itemCount = 0;
+			uint16_t x = 0;
+			uint16_t y = 0;
+			uint8_t z = 0;
+			bool isHouseTile = false;
+		};
+
+		// everything decoded from one tile area, written by a single thread
+		struct TileAreaBatch {
+			std::vector<DecodedTile> tiles;
+			std::vector<DecodedItem> items;
+			std::vector<char> props;
+			std::string error;
+		};
+
 		bool parseMapDataAttributes(OTB::Loader& loader, const OTB::Node& mapNode, Map& map, const std::filesystem::path& fileName);
 		bool parseWaypoints(OTB::Loader& loader, const OTB::Node& waypointsNode, Map& map);
 		bool parseTowns(OTB::Loader& loader, const OTB::Node& townsNode, Map& map);
-		bool parseTileArea(OTB::Loader& loader, const OTB::Node& tileAreaNode, Map& map);
+		static bool decodeTileArea(OTB::Loader& loader, const OTB::Node& tileAreaNode, TileAreaBatch& batch);
+		static bool decodeItem(const OTB::Node* itemNode, PropStream& propStream, TileAreaBatch& batch);
+		bool mergeTileArea(OTB::Loader& loader, TileAreaBatch& batch, Map& map);
 		std::string errorString;
 };
 
@@ -175,7 +175,7 @@ void IOMarket::checkExpiredOffers()
 		return;
 	}
 
-	g_scheduler.addEvent(createSchedulerTask(checkExpiredMarketOffersEachMinutes * 60 * 1000, &IOMarket::checkExpiredOffers));
+	g_scheduler.addEvent(createSchedulerTask("IOMarket::checkExpiredOffers", checkExpiredMarketOffersEachMinutes * 60 * 1000, &IOMarket::checkExpiredOffers));
 }
 
 uint32_t IOMarket::getPlayerOfferCount(uint32_t playerId)
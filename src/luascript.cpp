@@ -12,6 +12,7 @@
 #include "player.h"
 #include "game.h"
 #include "protocolstatus.h"
+#include "outputmessage.h"
 #include "spells.h"
 #include "iologindata.h"
 #include "iomapserialize.h"
@@ -1784,6 +1785,7 @@ void LuaScriptInterface::registerFunctions()
 	registerEnum(TILESTATE_FLOORCHANGE_SOUTH_ALT)
 	registerEnum(TILESTATE_FLOORCHANGE_EAST_ALT)
 	registerEnum(TILESTATE_SUPPORTS_HANGABLE)
+	registerEnum(TILESTATE_BLOCKPROJECTILE)
 
 	registerEnum(WEAPON_NONE)
 	registerEnum(WEAPON_SWORD)
@@ -2115,6 +2117,18 @@ void LuaScriptInterface::registerFunctions()
 	registerEnumIn("configKeys", ConfigManager::HEALTH_REGEN_NOTIFICATION);
 	registerEnumIn("configKeys", ConfigManager::MANA_REGEN_NOTIFICATION);
     registerEnumIn("configKeys", ConfigManager::AUTO_OPEN_CONTAINERS);
+	registerEnumIn("configKeys", ConfigManager::SCHEDULER_TIMER_WHEEL);
+	registerEnumIn("configKeys", ConfigManager::DISPATCHER_PROFILER);
+	registerEnumIn("configKeys", ConfigManager::DISPATCHER_PROFILER_INTERVAL);
+	registerEnumIn("configKeys", ConfigManager::PARALLEL_CREATURE_THINK);
+	registerEnumIn("configKeys", ConfigManager::PARALLEL_CREATURE_THINK_THREADS);
+	registerEnumIn("configKeys", ConfigManager::MAP_LEAF_GRID);
+	registerEnumIn("configKeys", ConfigManager::PARALLEL_MAP_LOADING);
+	registerEnumIn("configKeys", ConfigManager::FLOW_FIELD_PATHING);
+	registerEnumIn("configKeys", ConfigManager::ASYNC_PATHFINDING);
+	registerEnumIn("configKeys", ConfigManager::ASYNC_PATHFINDING_THREADS);
+	registerEnumIn("configKeys", ConfigManager::NETWORK_THREADS);
+	registerEnumIn("configKeys", ConfigManager::HIERARCHICAL_PATHFINDING);
 
 
 	registerEnumIn("configKeys", ConfigManager::SQL_PORT);
@@ -2196,6 +2210,13 @@ void LuaScriptInterface::registerFunctions()
 	registerMethod("Game", "getExperienceStage", LuaScriptInterface::luaGameGetExperienceStage);
 	registerMethod("Game", "getExperienceForLevel", LuaScriptInterface::luaGameGetExperienceForLevel);
 	registerMethod("Game", "getMonsterCount", LuaScriptInterface::luaGameGetMonsterCount);
+	registerMethod("Game", "getHibernatedMonsterCount", LuaScriptInterface::luaGameGetHibernatedMonsterCount);
+	registerMethod("Game", "getSpectatorCacheStats", LuaScriptInterface::luaGameGetSpectatorCacheStats);
+	registerMethod("Game", "getFlowFieldStats", LuaScriptInterface::luaGameGetFlowFieldStats);
+	registerMethod("Game", "getPathfindingStats", LuaScriptInterface::luaGameGetPathfindingStats);
+	registerMethod("Game", "getPathGraphStats", LuaScriptInterface::luaGameGetPathGraphStats);
+	registerMethod("Game", "getTileStats", LuaScriptInterface::luaGameGetTileStats);
+	registerMethod("Game", "getNetworkStats", LuaScriptInterface::luaGameGetNetworkStats);
 	registerMethod("Game", "getPlayerCount", LuaScriptInterface::luaGameGetPlayerCount);
 	registerMethod("Game", "getNpcCount", LuaScriptInterface::luaGameGetNpcCount);
 	registerMethod("Game", "getMonsterTypes", LuaScriptInterface::luaGameGetMonsterTypes);
@@ -2607,6 +2628,7 @@ void LuaScriptInterface::registerFunctions()
 	registerMethod("Creature", "getDescription", LuaScriptInterface::luaCreatureGetDescription);
 
 	registerMethod("Creature", "getPathTo", LuaScriptInterface::luaCreatureGetPathTo);
+	registerMethod("Creature", "getPathToAsync", LuaScriptInterface::luaCreatureGetPathToAsync);
 	registerMethod("Creature", "move", LuaScriptInterface::luaCreatureMove);
 
 	registerMethod("Creature", "getZone", LuaScriptInterface::luaCreatureGetZone);
@@ -4076,7 +4098,7 @@ int LuaScriptInterface::luaAddEvent(lua_State* L)
 	eventDesc.scriptId = getScriptEnv()->getScriptId();
 
 	auto& lastTimerEventId = g_luaEnvironment.lastEventTimerId;
-	eventDesc.eventId = g_scheduler.addEvent(createSchedulerTask(delay, [=]() { g_luaEnvironment.executeTimerEvent(lastTimerEventId); }));
+	eventDesc.eventId = g_scheduler.addEvent(createSchedulerTask("LuaEnvironment::executeTimerEvent", delay, [=]() { g_luaEnvironment.executeTimerEvent(lastTimerEventId); }));
 
 	g_luaEnvironment.timerEvents.emplace(lastTimerEventId, std::move(eventDesc));
 	lua_pushinteger(L, lastTimerEventId++);
@@ -4754,6 +4776,98 @@ int LuaScriptInterface::luaGameGetMonsterCount(lua_State* L)
 	return 1;
 }
 
+int LuaScriptInterface::luaGameGetHibernatedMonsterCount(lua_State* L)
+{
+	// Game.getHibernatedMonsterCount()
+	lua_pushinteger(L, g_game.getMonstersHibernated());
+	return 1;
+}
+
+int LuaScriptInterface::luaGameGetSpectatorCacheStats(lua_State* L)
+{
+	// Game.getSpectatorCacheStats()
+	const SpectatorCacheStats& stats = g_game.map.getSpectatorCacheStats();
+	lua_createtable(L, 0, 4);
+	setField(L, "hits", stats.hits);
+	setField(L, "misses", stats.misses);
+	setField(L, "evictions", stats.evictions);
+	setField(L, "size", g_game.map.getSpectatorCacheSize());
+	return 1;
+}
+
+int LuaScriptInterface::luaGameGetFlowFieldStats(lua_State* L)
+{
+	// Game.getFlowFieldStats()
+	const FlowFieldStats& stats = g_game.map.getFlowFieldStats();
+	lua_createtable(L, 0, 4);
+	setField(L, "built", stats.fieldsBuilt);
+	setField(L, "searchesAvoided", stats.searchesAvoided);
+	setField(L, "fallbacks", stats.fallbacks);
+	setField(L, "size", g_game.map.getFlowFieldCacheSize());
+	return 1;
+}
+
+int LuaScriptInterface::luaGameGetPathfindingStats(lua_State* L)
+{
+	// Game.getPathfindingStats()
+	const PathfindingStats& stats = g_game.pathfinders.getStats();
+	lua_createtable(L, 0, 7);
+	setField(L, "requests", stats.requests);
+	setField(L, "completed", stats.completed);
+	setField(L, "superseded", stats.superseded);
+	setField(L, "researched", stats.researched);
+	setField(L, "synchronous", stats.synchronous);
+	setField(L, "averageLatency", stats.completed != 0 ? stats.totalLatency / stats.completed : 0);
+	setField(L, "maxLatency", stats.maxLatency);
+	return 1;
+}
+
+int LuaScriptInterface::luaGameGetPathGraphStats(lua_State* L)
+{
+	// Game.getPathGraphStats()
+	const PathGraph& pathGraph = g_game.map.getPathGraph();
+	const PathGraphStats& stats = pathGraph.getStats();
+	lua_createtable(L, 0, 5);
+	setField(L, "searches", stats.searches);
+	setField(L, "found", stats.found);
+	setField(L, "refineFailures", stats.refineFailures);
+	setField(L, "rebuilds", stats.rebuilds);
+	setField(L, "clusters", pathGraph.getClusterCount());
+	return 1;
+}
+
+int LuaScriptInterface::luaGameGetTileStats(lua_State* L)
+{
+	// Game.getTileStats()
+	const TileStats& stats = g_game.map.getTileStats();
+	lua_createtable(L, 0, 3);
+	setField(L, "loaded", stats.loaded);
+	setField(L, "runtime", stats.runtime);
+	setField(L, "virtual", stats.virtualTiles);
+	return 1;
+}
+
+int LuaScriptInterface::luaGameGetNetworkStats(lua_State* L)
+{
+	// Game.getNetworkStats()
+	const ConnectionWriteStats& stats = ConnectionManager::getInstance().getWriteStats();
+	const uint64_t writes = stats.writes.load(std::memory_order_relaxed);
+	const uint64_t messages = stats.messages.load(std::memory_order_relaxed);
+	const uint64_t bytes = stats.bytes.load(std::memory_order_relaxed);
+	const auto& flushStats = OutputMessagePool::getInstance().getFlushStats();
+	lua_createtable(L, 0, 9);
+	setField(L, "writes", writes);
+	setField(L, "messages", messages);
+	setField(L, "bytes", bytes);
+	setField(L, "messagesPerWrite", writes != 0 ? static_cast<double>(messages) / writes : 0);
+	setField(L, "bytesPerWrite", writes != 0 ? bytes / writes : 0);
+	setField(L, "flushes", flushStats.flushes);
+	setField(L, "buffersPerFlush", flushStats.flushes != 0 ? static_cast<double>(flushStats.buffers) / flushStats.flushes : 0);
+	setField(L, "flushDelay", flushStats.flushes != 0 ? flushStats.delay / flushStats.flushes : 0);
+	setField(L, "maxFlushDelay", flushStats.maxDelay);
+	return 1;
+}
+
 int LuaScriptInterface::luaGameGetPlayerCount(lua_State* L)
 {
 	// Game.getPlayerCount()
@@ -5499,7 +5613,8 @@ int LuaScriptInterface::luaPositionGetZones(lua_State* L)
 	if (isTable(L, 1))
 	{
 		auto position = getPosition(L, 1);
-		auto zones = Zones::getZonesByPosition(position);
+		const auto& tile = g_game.map.getTile(position);
+		const auto& zones = tile ? tile->getZones() : Zones::getZonesByPosition(position);
 		auto index = 0;
 		lua_createtable(L, zones.size(), 0);
 
@@ -5522,7 +5637,8 @@ int LuaScriptInterface::luaPositionHasZone(lua_State* L)
 	if (isTable(L, 1))
 	{
 		auto position = getPosition(L, 1);
-		auto zones = Zones::getZonesByPosition(position);
+		const auto& tile = g_game.map.getTile(position);
+		const auto& zones = tile ? tile->getZones() : Zones::getZonesByPosition(position);
 		if (zones.empty()) 
 		{
 			pushBoolean(L, false);
@@ -10246,6 +10362,67 @@ int LuaScriptInterface::luaCreatureGetPathTo(lua_State* L)
 	return 1;
 }
 
+int LuaScriptInterface::luaCreatureGetPathToAsync(lua_State* L)
+{
+	// creature:getPathToAsync(pos, callback[, minTargetDist = 0[, maxTargetDist = 1[, fullPathSearch = true[, clearSight = true[, maxSearchDist = 0]]]]])
+	const auto creature = getSharedPtr<Creature>(L, 1);
+	if (!creature) {
+		lua_pushnil(L);
+		return 1;
+	}
+
+	if (!isFunction(L, 3)) {
+		reportErrorFunc(L, "callback parameter should be a function.");
+		pushBoolean(L, false);
+		return 1;
+	}
+
+	const Position& position = getPosition(L, 2);
+
+	FindPathParams fpp;
+	fpp.minTargetDist = getNumber<int32_t>(L, 4, 0);
+	fpp.maxTargetDist = getNumber<int32_t>(L, 5, 1);
+	fpp.fullPathSearch = getBoolean(L, 6, fpp.fullPathSearch);
+	fpp.clearSight = getBoolean(L, 7, fpp.clearSight);
+	fpp.maxSearchDist = getNumber<int32_t>(L, 8, fpp.maxSearchDist);
+
+	LuaTimerEventDesc eventDesc;
+	lua_pushvalue(L, 3);
+	eventDesc.function = luaL_ref(L, LUA_REGISTRYINDEX);
+	eventDesc.scriptId = getScriptEnv()->getScriptId();
+
+	const uint32_t timerEventId = g_luaEnvironment.lastEventTimerId++;
+	g_luaEnvironment.timerEvents.emplace(timerEventId, std::move(eventDesc));
+
+	// the callback always runs from its own task, callback(path) or callback(false)
+	g_game.pathfinders.findPath(creature, position, fpp, PathRequestKind::SCRIPT, [timerEventId](const CreaturePtr& creature, const bool found, std::vector<Direction>& dirList) {
+		g_dispatcher.addTask([timerEventId, found = found && creature, dirList = std::move(dirList)]() {
+			auto it = g_luaEnvironment.timerEvents.find(timerEventId);
+			if (it == g_luaEnvironment.timerEvents.end()) {
+				return;
+			}
+
+			lua_State* L = g_luaEnvironment.getLuaState();
+			if (found) {
+				lua_createtable(L, dirList.size(), 0);
+
+				int index = 0;
+				for (auto dirIt = dirList.rbegin(); dirIt != dirList.rend(); ++dirIt) {
+					lua_pushinteger(L, *dirIt);
+					lua_rawseti(L, -2, ++index);
+				}
+			} else {
+				pushBoolean(L, false);
+			}
+			it->second.parameters.push_back(luaL_ref(L, LUA_REGISTRYINDEX));
+			g_luaEnvironment.executeTimerEvent(timerEventId);
+		});
+	});
+
+	pushBoolean(L, true);
+	return 1;
+}
+
 int LuaScriptInterface::luaCreatureMove(lua_State* L)
 {
 	// creature:move(direction)
@@ -20969,10 +21146,18 @@ int LuaScriptInterface::luaCreateZone(lua_State* L)
 	// creates zone manually
 
 	// both return userdata
-	if (auto zoneId = getNumber<int>(L, 2))
+	if (auto zoneId = getNumber<int64_t>(L, 2))
 	{
 		if (zoneId != 0)
 		{
+			// ids that do not fit in 16 bits would alias other zones
+			if (not Zones::isValidId(zoneId))
+			{
+				reportErrorFunc(L, "Zone id out of range.");
+				lua_pushnil(L);
+				return 1;
+			}
+
 			if (auto hasPositions = isTable(L, 3))
 			{
 				std::vector<Position> positions{};
@@ -21048,20 +21233,20 @@ int LuaScriptInterface::luaZoneCreatures(lua_State* L)
 		int index = 0;
 		bool isFiltered = (isNumber(L, 2));
 		CreatureType_t creatureType;
-		lua_createtable(L, zone->positions.size() * 4, 0);
+		lua_createtable(L, std::min<size_t>(zone->getPositionCount() * 4, std::numeric_limits<uint16_t>::max()), 0);
 
 		if (isFiltered)
 		{
 			creatureType = getNumber<CreatureType_t>(L, 2);
 		}
 
-		for (auto& position : zone->positions)
+		zone->forEachPosition([&](const Position& position)
 		{
 			if (auto tile = g_game.map.getTile(position.x, position.y, position.z))
 			{
 				if (tile->getCreatureCount() == 0)
 				{
-					continue;
+					return;
 				}
 
 				for (auto& creature : *tile->getCreatures())
@@ -21076,7 +21261,7 @@ int LuaScriptInterface::luaZoneCreatures(lua_State* L)
 					lua_rawseti(L, -2, ++index);
 				}
 			}
-		}
+		});
 
 		return 1;
 	}
@@ -21089,9 +21274,9 @@ int LuaScriptInterface::luaZoneGrounds(lua_State* L)
 	// zone:getGrounds()
 	if (auto zone = getUserdata<Zone>(L, 1))
 	{
-		lua_createtable(L, zone->positions.size(), 0);
+		lua_createtable(L, std::min<size_t>(zone->getPositionCount(), std::numeric_limits<uint16_t>::max()), 0);
 		int index = 0;
-		for (auto& position : zone->positions)
+		zone->forEachPosition([&](const Position& position)
 		{
 			if (auto tile = g_game.map.getTile(position.x, position.y, position.z))
 			{
@@ -21102,7 +21287,7 @@ int LuaScriptInterface::luaZoneGrounds(lua_State* L)
 					lua_rawseti(L, -2, ++index);
 				}
 			}
-		}
+		});
 		return 1;
 	}
 	// should be unreachable
@@ -21118,14 +21303,14 @@ int LuaScriptInterface::luaZoneItems(lua_State* L)
 		bool isFiltered = (isNumber(L, 2));
 		int index = 0;
 		uint16_t item_type = 0;
-		lua_createtable(L, zone->positions.size() * 10, 0);
+		lua_createtable(L, std::min<size_t>(zone->getPositionCount() * 10, std::numeric_limits<uint16_t>::max()), 0);
 
 		if (isFiltered)
 		{
 			item_type = getNumber<uint16_t>(L, 2);
 		}
 
-		for (auto& position : zone->positions)
+		zone->forEachPosition([&](const Position& position)
 		{
 			if (auto tile = g_game.map.getTile(position.x, position.y, position.z))
 			{
@@ -21144,7 +21329,7 @@ int LuaScriptInterface::luaZoneItems(lua_State* L)
 					}
 				}
 			}
-		}
+		});
 		return 1;
 	}
 	// should be unreachable
@@ -21166,21 +21351,21 @@ int LuaScriptInterface::luaZoneTiles(lua_State* L)
 			flags = (getNumber<uint32_t>(L, 2));
 		}
 
-		lua_createtable(L, zone->positions.size(), 0);
+		lua_createtable(L, std::min<size_t>(zone->getPositionCount(), std::numeric_limits<uint16_t>::max()), 0);
 
-		for (auto& position : zone->positions)
+		zone->forEachPosition([&](const Position& position)
 		{
 			if (auto tile = g_game.map.getTile(position.x, position.y, position.z))
 			{
 				if (isFiltered and (tile->getFlags() & flags) != flags)
 				{
-					continue;
+					return;
 				}
 				pushSharedPtr(L, tile);
 				setMetatable(L, -1, "Tile");
 				lua_rawseti(L, -2, ++index);
 			}
-		}
+		});
 		return 1;
 	}
 	// should be unreachable
@@ -21202,7 +21387,7 @@ int LuaScriptInterface::luaZoneCreatureCount(lua_State* L)
 			creatureType = (getNumber<CreatureType_t>(L, 2));
 		}
 
-		for (auto& position : zone->positions)
+		zone->forEachPosition([&](const Position& position)
 		{
 			if (auto tile = g_game.map.getTile(position.x, position.y, position.z))
 			{
@@ -21225,7 +21410,7 @@ int LuaScriptInterface::luaZoneCreatureCount(lua_State* L)
 					}
 				}
 			}
-		}
+		});
 		lua_pushnumber(L, c_count);
 		return 1;
 	}
@@ -21248,7 +21433,7 @@ int LuaScriptInterface::luaZoneItemCount(lua_State* L)
 			itemId = (getNumber<int>(L, 2));
 		}
 
-		for (auto& position : zone->positions)
+		zone->forEachPosition([&](const Position& position)
 		{
 			if (auto tile = g_game.map.getTile(position.x, position.y, position.z))
 			{
@@ -21271,7 +21456,7 @@ int LuaScriptInterface::luaZoneItemCount(lua_State* L)
 					}
 				}
 			}
-		}
+		});
 		lua_pushnumber(L, i_count);
 		return 1;
 	}
@@ -21294,17 +21479,17 @@ int LuaScriptInterface::luaZoneTileCount(lua_State* L)
 			flags = (getNumber<tileflags_t>(L, 2));
 		}
 
-		for (auto& position : zone->positions)
+		zone->forEachPosition([&](const Position& position)
 		{
 			if (auto tile = g_game.map.getTile(position.x, position.y, position.z))
 			{
 				if (isFiltered and (tile->getFlags() & flags) != flags)
 				{
-					continue;
+					return;
 				}
 				++t_count;
 			}
-		}
+		});
 		lua_pushnumber(L, t_count);
 		return 1;
 	}
@@ -603,6 +603,13 @@ class LuaScriptInterface
 		static int luaGameGetExperienceStage(lua_State* L);
 		static int luaGameGetExperienceForLevel(lua_State* L);
 		static int luaGameGetMonsterCount(lua_State* L);
+		static int luaGameGetHibernatedMonsterCount(lua_State* L);
+		static int luaGameGetSpectatorCacheStats(lua_State* L);
+		static int luaGameGetFlowFieldStats(lua_State* L);
+		static int luaGameGetPathfindingStats(lua_State* L);
+		static int luaGameGetPathGraphStats(lua_State* L);
+		static int luaGameGetTileStats(lua_State* L);
+		static int luaGameGetNetworkStats(lua_State* L);
 		static int luaGameGetPlayerCount(lua_State* L);
 		static int luaGameGetNpcCount(lua_State* L);
 		static int luaGameGetMonsterTypes(lua_State* L);
@@ -1003,6 +1010,7 @@ class LuaScriptInterface
 		static int luaCreatureGetDescription(lua_State* L);
 
 		static int luaCreatureGetPathTo(lua_State* L);
+		static int luaCreatureGetPathToAsync(lua_State* L);
 		static int luaCreatureMove(lua_State* L);
 
 		static int luaCreatureGetZone(lua_State* L);
@@ -9,13 +9,20 @@
 #include "creature.h"
 #include "game.h"
 #include "monster.h"
+#include "configmanager.h"
+
+#include <queue>
 
 extern Game g_game;
+extern ConfigManager g_config;
 
 bool Map::loadMap(const std::string& identifier, bool loadHouses)
 {
 	IOMap loader;
-	if (!loader.loadMap(this, identifier)) {
+	loadingTiles = true;
+	const bool loaded = loader.loadMap(this, identifier);
+	loadingTiles = false;
+	if (!loaded) {
 		std::cout << "[Fatal - Map::loadMap] " << loader.getLastErrorString() << std::endl;
 		return false;
 	}
@@ -65,7 +72,7 @@ TilePtr Map::getTile(const uint16_t x, const uint16_t y, const uint8_t z)
 		return nullptr;
 	}
 
-	auto leaf = QTreeNode::getLeafStatic< QTreeLeafNode*, QTreeNode*>(&root, x, y);
+	const auto leaf = getQTNode(x, y);
 	if (!leaf) {
 		return nullptr;
 	}
@@ -88,6 +95,10 @@ void Map::setTile(const uint16_t x, const uint16_t y, const uint8_t z, TilePtr&
 	const auto& leaf = root.createLeaf(x, y, 15);
 
 	if (QTreeLeafNode::newLeaf) {
+		if (useLeafGrid) {
+			leafGrid.set(x, y, leaf);
+		}
+
 		//update north
 		if (const auto& northLeaf = root.getLeaf(x, y - FLOOR_SIZE)) {
 			northLeaf->leafS = leaf;
@@ -127,16 +138,31 @@ void Map::setTile(const uint16_t x, const uint16_t y, const uint8_t z, TilePtr&
 		}
 	} else {
 		tile = newTile;
+		tile->setZoneSetId(Zones::getZoneSetId(Position(x, y, z)));
+		onTilePathingChange(Position(x, y, z));
+		onTileSightChange(Position(x, y, z));
+
+		if (loadingTiles) {
+			++tileStats.loaded;
+		} else {
+			++tileStats.runtime;
+		}
 	}
 }
 
+TilePtr Map::createVirtualTile(const Position& pos)
+{
+	++tileStats.virtualTiles;
+	return std::make_shared<Tile>(pos.x, pos.y, pos.z);
+}
+
 void Map::removeTile(const uint16_t x, const uint16_t y, const uint8_t z) const
 {
 	if (z >= MAP_MAX_LAYERS) {
 		return;
 	}
 
-	const auto& leaf = QTreeNode::getLeafStatic<const QTreeLeafNode*, const QTreeNode*>(&root, x, y);
+	const auto& leaf = getQTNode(x, y);
 	if (!leaf) {
 		return;
 	}
@@ -285,6 +311,8 @@ void Map::moveCreature(CreaturePtr& creature, const TilePtr& newTile, bool force
 	if (leaf != new_leaf) {
 		leaf->removeCreature(creature);
 		new_leaf->addCreature(creature);
+	} else {
+		leaf->onCreatureMove(creature);
 	}
 
 	//add the creature
@@ -318,7 +346,7 @@ void Map::moveCreature(CreaturePtr& creature, const TilePtr& newTile, bool force
 	//event method
 	for (const auto& spectator : spectators) {
 		if (const auto& monster = spectator->getMonster(); monster)
-				monster->setIdle(false);
+				monster->wakeUpBy(creature);
 		spectator->onCreatureMove(creature, newTile, newPos, oldTile, oldPos, teleport);
 	}
 
@@ -326,7 +354,8 @@ void Map::moveCreature(CreaturePtr& creature, const TilePtr& newTile, bool force
 	newTile->postAddNotification(creature, oldTile, 0);
 }
 
-void Map::getSpectatorsInternal(SpectatorVec& spectators, const Position& centerPos, const int32_t minRangeX, const int32_t maxRangeX, const int32_t minRangeY, const int32_t maxRangeY, const int32_t minRangeZ, const int32_t maxRangeZ, const bool onlyPlayers) const
+void Map::getSpectatorsInternal(SpectatorVec& spectators, const Position& centerPos, const int32_t minRangeX, const int32_t maxRangeX, const int32_t minRangeY, const int32_t maxRangeY, const int32_t minRangeZ, const int32_t maxRangeZ, const bool onlyPlayers,
+                                std::vector<std::pair<const QTreeLeafNode*, uint32_t>>* leafVersions /*= nullptr*/) const
 {
     const auto min_y = centerPos.y + minRangeY;
     const auto min_x = centerPos.x + minRangeX;
@@ -353,13 +382,17 @@ void Map::getSpectatorsInternal(SpectatorVec& spectators, const Position& center
     const int32_t endx2 = x2 - (x2 % FLOOR_SIZE);
     const int32_t endy2 = y2 - (y2 % FLOOR_SIZE);
 
-    const auto& startLeaf = QTreeNode::getLeafStatic<const QTreeLeafNode*, const QTreeNode*>(&root, startx1, starty1);
+    const auto& startLeaf = getQTNode(startx1, starty1);
     auto leafS = startLeaf;
 
     for (int_fast32_t ny = starty1; ny <= endy2; ny += FLOOR_SIZE) {
         const QTreeLeafNode* leafE = leafS;
         for (int_fast32_t nx = startx1; nx <= endx2; nx += FLOOR_SIZE) {
             if (leafE) {
+                if (leafVersions) {
+                    leafVersions->emplace_back(leafE, onlyPlayers ? leafE->playerVersion : leafE->creatureVersion);
+                }
+
                 const auto& node_list = (onlyPlayers ? leafE->player_list : leafE->creature_list);
                 std::ranges::for_each(node_list, [&](const CreaturePtr& creature) {
                     const Position& cpos = creature->getPosition();
@@ -376,14 +409,14 @@ void Map::getSpectatorsInternal(SpectatorVec& spectators, const Position& center
                 });
                 leafE = leafE->leafE;
             } else {
-                leafE = QTreeNode::getLeafStatic<const QTreeLeafNode*, const QTreeNode*>(&root, nx + FLOOR_SIZE, ny);
+                leafE = getQTNode(nx + FLOOR_SIZE, ny);
             }
         }
 
         if (leafS) {
             leafS = leafS->leafS;
         } else {
-            leafS = QTreeNode::getLeafStatic<const QTreeLeafNode*, const QTreeNode*>(&root, startx1, ny + FLOOR_SIZE);
+            leafS = getQTNode(startx1, ny + FLOOR_SIZE);
         }
     }
 }
@@ -394,9 +427,6 @@ void Map::getSpectators(SpectatorVec& spectators, const Position& centerPos, con
         return;
     }
 
-    bool foundCache = false;
-    bool cacheResult = false;
-
     minRangeX = (minRangeX == 0 ? -maxViewportX : -minRangeX);
     maxRangeX = (maxRangeX == 0 ? maxViewportX : maxRangeX);
     minRangeY = (minRangeY == 0 ? -maxViewportY : -minRangeY);
@@ -412,84 +442,106 @@ void Map::getSpectators(SpectatorVec& spectators, const Position& centerPos, con
 	chunkKey.multifloor = multifloor;
 	chunkKey.onlyPlayers = onlyPlayers;
 
-    if (const auto it = chunksSpectatorCache.find(chunkKey); it != chunksSpectatorCache.end()) {
-		if (!spectators.empty()) {
-			spectators.addSpectators(it->second);
-		} else {
-			spectators = it->second;
-		}
-		foundCache = true;
-	} else {
-		cacheResult = true;
-	}
+	++spectatorCacheTick;
 
-    if (minRangeX == -maxViewportX && maxRangeX == maxViewportX && minRangeY == -maxViewportY && maxRangeY == maxViewportY && multifloor) {
-        if (onlyPlayers) {
-	        if (const auto it = playersSpectatorCache.find(centerPos); it != playersSpectatorCache.end()) {
-                spectators.addSpectators(it->second);
-                foundCache = true;
-            }
-        }
+	auto it = chunksSpectatorCache.find(chunkKey);
+	if (it != chunksSpectatorCache.end() && isSpectatorCacheValid(it->second, onlyPlayers)) {
+		++spectatorCacheStats.hits;
+		it->second.lastUse = spectatorCacheTick;
+		appendCachedSpectators(it->second, spectators);
+		return;
+	}
 
-        if (!foundCache) {
-	        if (const auto it = spectatorCache.find(centerPos); it != spectatorCache.end()) {
-                if (!onlyPlayers) {
-                    const SpectatorVec& cachedSpectators = it->second;
-                    spectators.addSpectators(cachedSpectators);
-                } else {
-                    for (const auto& spectator : it->second) {
-                        if (spectator->getPlayer()) {
-                            spectators.emplace_back(spectator);
-                        }
-                    }
-                }
-                foundCache = true;
-            } else {
-                cacheResult = true;
-            }
+	++spectatorCacheStats.misses;
+	if (it == chunksSpectatorCache.end()) {
+		if (chunksSpectatorCache.size() >= MAX_SPECTATOR_CACHE_SIZE) {
+			evictSpectatorCache();
+		}
+		it = chunksSpectatorCache.try_emplace(chunkKey).first;
+	}
+
+    int32_t minRangeZ;
+    int32_t maxRangeZ;
+
+    if (multifloor) {
+        if (centerPos.z > 7) {
+            //underground (8->15)
+            minRangeZ = std::max<int32_t>(centerPos.getZ() - 2, 0);
+            maxRangeZ = std::min<int32_t>(centerPos.getZ() + 2, MAP_MAX_LAYERS - 1);
+        } else if (centerPos.z == 6) {
+            minRangeZ = 0;
+            maxRangeZ = 8;
+        } else if (centerPos.z == 7) {
+            minRangeZ = 0;
+            maxRangeZ = 9;
+        } else {
+            minRangeZ = 0;
+            maxRangeZ = 7;
         }
+    } else {
+        minRangeZ = centerPos.z;
+        maxRangeZ = centerPos.z;
     }
 
-    if (!foundCache) {
-        int32_t minRangeZ;
-        int32_t maxRangeZ;
-
-        if (multifloor) {
-            if (centerPos.z > 7) {
-                //underground (8->15)
-                minRangeZ = std::max<int32_t>(centerPos.getZ() - 2, 0);
-                maxRangeZ = std::min<int32_t>(centerPos.getZ() + 2, MAP_MAX_LAYERS - 1);
-            } else if (centerPos.z == 6) {
-                minRangeZ = 0;
-                maxRangeZ = 8;
-            } else if (centerPos.z == 7) {
-                minRangeZ = 0;
-                maxRangeZ = 9;
-            } else {
-                minRangeZ = 0;
-                maxRangeZ = 7;
-            }
-        } else {
-            minRangeZ = centerPos.z;
-            maxRangeZ = centerPos.z;
-        }
+	// a stale entry is refreshed in place
+	SpectatorCacheEntry& entry = it->second;
+	entry.spectators.clear();
+	entry.leafVersions.clear();
+	entry.leafGeneration = QTreeLeafNode::leafGeneration;
+	entry.lastUse = spectatorCacheTick;
+
+	if (spectators.empty()) {
+		getSpectatorsInternal(spectators, centerPos, minRangeX, maxRangeX, minRangeY, maxRangeY, minRangeZ, maxRangeZ, onlyPlayers, &entry.leafVersions);
+		entry.spectators.assign(spectators.begin(), spectators.end());
+	} else {
+		SpectatorVec found;
+		getSpectatorsInternal(found, centerPos, minRangeX, maxRangeX, minRangeY, maxRangeY, minRangeZ, maxRangeZ, onlyPlayers, &entry.leafVersions);
+		entry.spectators.assign(found.begin(), found.end());
+		spectators.addSpectators(found);
+	}
+}
 
-        getSpectatorsInternal(spectators, centerPos, minRangeX, maxRangeX, minRangeY, maxRangeY, minRangeZ, maxRangeZ, onlyPlayers);
+bool Map::isSpectatorCacheValid(const SpectatorCacheEntry& entry, const bool onlyPlayers)
+{
+	if (entry.leafGeneration != QTreeLeafNode::leafGeneration) {
+		return false;
+	}
 
-        if (cacheResult) {
-            chunksSpectatorCache.emplace(chunkKey, spectators);
-        }
-    }
+	const bool leavesUnchanged = std::ranges::all_of(entry.leafVersions, [onlyPlayers](const auto& leafVersion) {
+		const auto& [leaf, version] = leafVersion;
+		return (onlyPlayers ? leaf->playerVersion : leaf->creatureVersion) == version;
+	});
+
+	// unchanged leaves still hold every creature, this only guards against a
+	// creature released without going through the map
+	return leavesUnchanged && std::ranges::none_of(entry.spectators, [](const auto& spectator) { return spectator.expired(); });
 }
 
-void Map::clearSpectatorCache()
+void Map::appendCachedSpectators(const SpectatorCacheEntry& entry, SpectatorVec& spectators)
 {
-	spectatorCache.clear();
+	const bool checkDuplicates = !spectators.empty();
+	for (const auto& spectator : entry.spectators) {
+		CreaturePtr creature = spectator.lock();
+		if (checkDuplicates && std::ranges::find(spectators, creature) != spectators.end()) {
+			continue;
+		}
+		spectators.emplace_back(std::move(creature));
+	}
 }
 
-void Map::clearPlayersSpectatorCache()
+void Map::evictSpectatorCache()
 {
-	playersSpectatorCache.clear();
+	// drop whatever is stale or was not used during the last half cache size lookups,
+	// at most half of the entries can be that recent so this always frees room
+	const uint64_t threshold = spectatorCacheTick > MAX_SPECTATOR_CACHE_SIZE / 2 ? spectatorCacheTick - MAX_SPECTATOR_CACHE_SIZE / 2 : 0;
+	for (auto it = chunksSpectatorCache.begin(); it != chunksSpectatorCache.end();) {
+		if (it->second.lastUse < threshold || !isSpectatorCacheValid(it->second, it->first.onlyPlayers)) {
+			chunksSpectatorCache.erase(it++);
+			++spectatorCacheStats.evictions;
+		} else {
+			++it;
+		}
+	}
 }
 
 bool Map::canThrowObjectTo(const Position& fromPos, const Position& toPos, const bool checkLineOfSight /*= true*/, const bool sameFloor /*= false*/,
@@ -504,21 +556,71 @@ bool Map::canThrowObjectTo(const Position& fromPos, const Position& toPos, const
 
 bool Map::isTileClear(const uint16_t x, const uint16_t y, const uint8_t z, const bool blockFloor /*= false*/)
 {
-	auto tile = getTile(x, y, z);
-	if (!tile) {
+	if (blockFloor) {
+		auto tile = getTile(x, y, z);
+		if (!tile) {
+			return true;
+		}
+
+		return !tile->getGround() && !tile->hasFlag(TILESTATE_BLOCKPROJECTILE);
+	}
+
+	if (z >= MAP_MAX_LAYERS) {
 		return true;
 	}
 
-	if (blockFloor && tile->getGround()) {
-		return false;
+	const QTreeLeafNode* leaf = getQTNode(x, y);
+	if (!leaf) {
+		return true;
 	}
 
-	return !tile->hasProperty(CONST_PROP_BLOCKPROJECTILE);
+	const Floor* floor = leaf->getFloor(z);
+	if (!floor) {
+		return true;
+	}
+	return (floor->projectileBlocking & (uint64_t{1} << ((x & FLOOR_MASK) * FLOOR_SIZE + (y & FLOOR_MASK)))) == 0;
 }
 
 namespace {
 
-bool checkSteepLine(const uint16_t x0, const uint16_t y0, const uint16_t x1, const uint16_t y1, const uint8_t z)
+// Tests the tiles of a sight line against the projectile blocking bits of their floor. A line
+// stays inside one 8x8 floor for several tiles in a row, the floor is only looked up again
+// when the line crosses into the next one.
+class ProjectileBlockingReader
+{
+	public:
+		ProjectileBlockingReader(const Map& map, const uint8_t z) : map(map), z(z) {}
+
+		bool operator()(const uint16_t x, const uint16_t y) const {
+			const uint32_t floorKey = (static_cast<uint32_t>(x >> FLOOR_BITS) << 16) | (y >> FLOOR_BITS);
+			if (floorKey != currentFloorKey) {
+				currentFloorKey = floorKey;
+				const QTreeLeafNode* leaf = map.getQTNode(x, y);
+				const Floor* floor = leaf ? leaf->getFloor(z) : nullptr;
+				blocking = floor ? floor->projectileBlocking : 0;
+			}
+			return (blocking & (uint64_t{1} << ((x & FLOOR_MASK) * FLOOR_SIZE + (y & FLOOR_MASK)))) == 0;
+		}
+
+	private:
+		const Map& map;
+		const uint8_t z;
+		mutable uint32_t currentFloorKey = std::numeric_limits<uint32_t>::max();
+		mutable uint64_t blocking = 0;
+};
+
+struct SightMemo {
+	static constexpr size_t MAX_SIZE = 8192;
+
+	gtl::flat_hash_map<uint64_t, bool> results;
+	uint64_t epoch = std::numeric_limits<uint64_t>::max();
+};
+
+// one per thread, monsters may check their sight on the think workers
+thread_local SightMemo sightMemo;
+
+template <typename TileClear>
+bool checkSteepLine(const uint16_t x0, const uint16_t y0, const uint16_t x1, const uint16_t y1, const TileClear& isTileClear)
 {
 	const float dx = x1 - x0;
 	const float slope = (dx == 0) ? 1 : (y1 - y0) / dx;
@@ -526,7 +628,7 @@ bool checkSteepLine(const uint16_t x0, const uint16_t y0, const uint16_t x1, con
 
 	for (uint16_t x = x0 + 1; x < x1; ++x) {
 		//0.1 is necessary to avoid loss of precision during calculation
-		if (!g_game.map.isTileClear(std::floor(yi + 0.1), x, z)) {
+		if (!isTileClear(std::floor(yi + 0.1), x)) {
 			return false;
 		}
 		yi += slope;
@@ -535,7 +637,8 @@ bool checkSteepLine(const uint16_t x0, const uint16_t y0, const uint16_t x1, con
 	return true;
 }
 
-bool checkSlightLine(const uint16_t x0, const uint16_t y0, const uint16_t x1, const uint16_t y1, const uint8_t z)
+template <typename TileClear>
+bool checkSlightLine(const uint16_t x0, const uint16_t y0, const uint16_t x1, const uint16_t y1, const TileClear& isTileClear)
 {
 	const float dx = x1 - x0;
 	const float slope = (dx == 0) ? 1 : (y1 - y0) / dx;
@@ -543,7 +646,7 @@ bool checkSlightLine(const uint16_t x0, const uint16_t y0, const uint16_t x1, co
 
 	for (uint16_t x = x0 + 1; x < x1; ++x) {
 		//0.1 is necessary to avoid loss of precision during calculation
-		if (!g_game.map.isTileClear(x, std::floor(yi + 0.1), z)) {
+		if (!isTileClear(x, std::floor(yi + 0.1))) {
 			return false;
 		}
 		yi += slope;
@@ -552,9 +655,8 @@ bool checkSlightLine(const uint16_t x0, const uint16_t y0, const uint16_t x1, co
 	return true;
 }
 
-}
-
-bool Map::checkSightLine(const uint16_t x0, const uint16_t y0, const uint16_t x1, const uint16_t y1, const uint8_t z)
+template <typename TileClear>
+bool checkSightLineWith(const uint16_t x0, const uint16_t y0, const uint16_t x1, const uint16_t y1, const TileClear& isTileClear)
 {
 	if (x0 == x1 && y0 == y1) {
 		return true;
@@ -562,16 +664,26 @@ bool Map::checkSightLine(const uint16_t x0, const uint16_t y0, const uint16_t x1
 
 	if (std::abs(y1 - y0) > std::abs(x1 - x0)) {
 		if (y1 > y0) {
-			return checkSteepLine(y0, x0, y1, x1, z);
+			return checkSteepLine(y0, x0, y1, x1, isTileClear);
 		}
-		return checkSteepLine(y1, x1, y0, x0, z);
+		return checkSteepLine(y1, x1, y0, x0, isTileClear);
 	}
 
 	if (x0 > x1) {
-		return checkSlightLine(x1, y1, x0, y0, z);
+		return checkSlightLine(x1, y1, x0, y0, isTileClear);
 	}
 
-	return checkSlightLine(x0, y0, x1, y1, z);
+	return checkSlightLine(x0, y0, x1, y1, isTileClear);
+}
+
+}
+
+bool Map::checkSightLine(const uint16_t x0, const uint16_t y0, const uint16_t x1, const uint16_t y1, const uint8_t z)
+{
+	if (z >= MAP_MAX_LAYERS) {
+		return true;
+	}
+	return checkSightLineWith(x0, y0, x1, y1, ProjectileBlockingReader(g_game.map, z));
 }
 
 bool Map::isSightClear(const Position& fromPos, const Position& toPos, const bool sameFloor /*= false*/)
@@ -648,6 +760,62 @@ bool Map::isSightClear(const Position& fromPos, const Position& toPos, const boo
 	return checkSightLine(fromPos.x, fromPos.y, toPos.x, toPos.y, fromPos.z);
 }
 
+bool Map::isSightClearCached(const Position& fromPos, const Position& toPos, const bool sameFloor /*= false*/)
+{
+	if (fromPos == toPos) {
+		return true;
+	}
+
+	const int32_t offsetX = toPos.x - fromPos.x;
+	const int32_t offsetY = toPos.y - fromPos.y;
+	if (std::abs(offsetX) > std::numeric_limits<int8_t>::max() || std::abs(offsetY) > std::numeric_limits<int8_t>::max()) {
+		return isSightClear(fromPos, toPos, sameFloor);
+	}
+
+	const uint64_t key = static_cast<uint64_t>(fromPos.x) | (static_cast<uint64_t>(fromPos.y) << 16) |
+		(static_cast<uint64_t>(fromPos.z & 0x0F) << 32) | (static_cast<uint64_t>(toPos.z & 0x0F) << 36) |
+		(static_cast<uint64_t>(static_cast<uint8_t>(offsetX)) << 40) | (static_cast<uint64_t>(static_cast<uint8_t>(offsetY)) << 48) |
+		(static_cast<uint64_t>(sameFloor) << 56);
+
+	if (sightMemo.epoch != sightEpoch) {
+		sightMemo.results.clear();
+		sightMemo.epoch = sightEpoch;
+	}
+
+	if (auto it = sightMemo.results.find(key); it != sightMemo.results.end()) {
+		return it->second;
+	}
+
+	const bool sightClear = isSightClear(fromPos, toPos, sameFloor);
+	if (sightMemo.results.size() < SightMemo::MAX_SIZE) {
+		sightMemo.results.emplace(key, sightClear);
+	}
+	return sightClear;
+}
+
+int32_t Map::getWalkCache(const Position& pos, const uint8_t movementClass)
+{
+	if (pos.z >= MAP_MAX_LAYERS) {
+		return 0;
+	}
+
+	QTreeLeafNode* leaf = getQTNode(pos.x, pos.y);
+	Floor* floor = leaf ? leaf->getFloor(pos.z) : nullptr;
+	if (!floor) {
+		return 0;
+	}
+
+	const uint32_t offsetX = pos.x & FLOOR_MASK;
+	const uint32_t offsetY = pos.y & FLOOR_MASK;
+	if ((floor->getPassableTiles(movementClass) & (uint64_t{1} << (offsetX * FLOOR_SIZE + offsetY))) == 0) {
+		return 0;
+	}
+
+	// creatures move every step, tiles with any on them get the full check
+	const auto& creatures = floor->tiles[offsetX][offsetY]->getCreatures();
+	return creatures && !creatures->empty() ? 2 : 1;
+}
+
 TilePtr Map::canWalkTo(CreaturePtr& creature, const Position& pos)
 {
 	const int32_t& walkCache = creature->getWalkCache(pos);
@@ -676,9 +844,76 @@ TilePtr Map::canWalkTo(CreaturePtr& creature, const Position& pos)
 	return tile;
 }
 
-bool Map::getPathMatching(CreaturePtr& creature, std::vector<Direction>& dirList, const FrozenPathingConditionCall& pathCondition, const FindPathParams& fpp)
+namespace {
+
+// reads walkability straight from the map, only on the dispatcher
+struct MapPathWalker {
+	Map& map;
+	CreaturePtr& creature;
+
+	bool getWalkCost(const Position& pos, const bool known, int_fast32_t& extraCost) const {
+		// tiles already in the search were walkable when they were added
+		TilePtr tile = known ? map.getTile(pos.x, pos.y, pos.z) : map.canWalkTo(creature, pos);
+		if (!tile) {
+			return false;
+		}
+
+		extraCost = AStarNodes::getTileWalkCost(creature, tile);
+		return true;
+	}
+
+	bool isSightClear(const Position& fromPos, const Position& toPos) const {
+		return g_game.isSightClear(fromPos, toPos, true);
+	}
+};
+
+// reads walkability from a snapshot, anything outside of it counts as blocked
+struct SnapshotPathWalker {
+	const WalkabilitySnapshot& snapshot;
+	mutable bool leftSnapshot = false;
+
+	bool getWalkCost(const Position& pos, bool, int_fast32_t& extraCost) const {
+		if (!snapshot.contains(pos.x, pos.y, pos.z)) {
+			leftSnapshot = true;
+			return false;
+		}
+
+		const int16_t cost = snapshot.getWalkCost(pos.x, pos.y);
+		if (cost == WalkabilitySnapshot::BLOCKED) {
+			return false;
+		}
+
+		extraCost = cost;
+		return true;
+	}
+
+	// Map::isSightClear with sameFloor set
+	bool isSightClear(const Position& fromPos, const Position& toPos) const {
+		if (fromPos == toPos) {
+			return true;
+		}
+
+		if (fromPos.z != toPos.z) {
+			return false;
+		}
+
+		if (Position::getDistanceX(fromPos, toPos) < 2 && Position::getDistanceY(fromPos, toPos) < 2) {
+			return true;
+		}
+
+		return checkSightLineWith(fromPos.x, fromPos.y, toPos.x, toPos.y, [this, z = fromPos.z](const uint16_t x, const uint16_t y) {
+			if (!snapshot.contains(x, y, z)) {
+				leftSnapshot = true;
+				return false;
+			}
+			return snapshot.isTileClear(x, y);
+		});
+	}
+};
+
+template <typename Walker>
+bool findPath(const Walker& walker, Position pos, std::vector<Direction>& dirList, const FrozenPathingConditionCall& pathCondition, const FindPathParams& fpp)
 {
-	Position pos = creature->getPosition();
 	Position endPos;
 
 	AStarNodes nodes(pos.x, pos.y);
@@ -715,7 +950,7 @@ bool Map::getPathMatching(CreaturePtr& creature, std::vector<Direction>& dirList
 		const int_fast32_t y = n->y;
 		pos.x = x;
 		pos.y = y;
-		if (pathCondition(startPos, pos, fpp, bestMatch)) {
+		if (pathCondition(startPos, pos, fpp, bestMatch, [&walker](const Position& fromPos, const Position& toPos) { return walker.isSightClear(fromPos, toPos); })) {
 			found = n;
 			endPos = pos;
 			if (bestMatch == 0) {
@@ -771,16 +1006,13 @@ bool Map::getPathMatching(CreaturePtr& creature, std::vector<Direction>& dirList
 			}
 
 			auto neighborNode = nodes.getNodeByPosition(pos.x, pos.y);
-			TilePtr tile = neighborNode ? getTile(pos.x, pos.y, pos.z) : canWalkTo(creature, pos);
-
-			if (!tile) 
-			{
+			int_fast32_t extraCost;
+			if (!walker.getWalkCost(pos, neighborNode != nullptr, extraCost)) {
 				continue;
 			}
-			
+
 			//The cost (g) for this neighbor
 			const int_fast32_t cost = AStarNodes::getMapWalkCost(n, pos);
-			const int_fast32_t extraCost = AStarNodes::getTileWalkCost(creature, tile);
 			const int_fast32_t newf = f + cost + extraCost;
 
 			if (neighborNode) {
@@ -848,21 +1080,540 @@ bool Map::getPathMatching(CreaturePtr& creature, std::vector<Direction>& dirList
 	return true;
 }
 
+}
+
+bool Map::getPathMatching(CreaturePtr& creature, std::vector<Direction>& dirList, const FrozenPathingConditionCall& pathCondition, const FindPathParams& fpp)
+{
+	return findPath(MapPathWalker{*this, creature}, creature->getPosition(), dirList, pathCondition, fpp);
+}
+
+bool Map::getPathMatching(const WalkabilitySnapshot& snapshot, const Position& startPos, std::vector<Direction>& dirList,
+                          const FrozenPathingConditionCall& pathCondition, const FindPathParams& fpp, bool& incomplete)
+{
+	const SnapshotPathWalker walker{snapshot};
+	const bool found = findPath(walker, startPos, dirList, pathCondition, fpp);
+	incomplete = walker.leftSnapshot;
+	return found;
+}
+
+bool Map::getHierarchicalPath(CreaturePtr& creature, const Position& targetPos, std::vector<Direction>& dirList, const FindPathParams& fpp)
+{
+	if (!pathGraph.isEnabled() || !fpp.fullPathSearch || fpp.keepDistance) {
+		return false;
+	}
+
+	Position pos = creature->getPosition();
+	const int32_t distance = std::max<int32_t>(Position::getDistanceX(pos, targetPos), Position::getDistanceY(pos, targetPos));
+	if (pos.z != targetPos.z || distance <= PathGraph::CLUSTER_SIZE || (fpp.maxSearchDist != 0 && distance > fpp.maxSearchDist)) {
+		return false;
+	}
+
+	std::vector<Position> waypoints;
+	if (!pathGraph.findWaypoints(*this, pos, targetPos, waypoints)) {
+		return false;
+	}
+
+	// every stretch ends exactly on its entrance, only the last one is searched like the caller asked
+	FindPathParams stretchParams;
+	stretchParams.clearSight = false;
+	stretchParams.minTargetDist = 0;
+	stretchParams.maxTargetDist = 0;
+	stretchParams.maxSearchDist = PathGraph::CLUSTER_SIZE * 2;
+
+	const MapPathWalker walker{*this, creature};
+	std::vector<Direction> steps;
+	std::vector<Direction> stretch;
+	for (size_t i = 0; i < waypoints.size(); ++i) {
+		const Position& waypoint = waypoints[i];
+		const bool last = i + 1 == waypoints.size();
+		if (!last) {
+			if (pos == waypoint) {
+				continue;
+			}
+
+			// the step across a cluster border
+			if (Position::getDistanceX(pos, waypoint) <= 1 && Position::getDistanceY(pos, waypoint) <= 1) {
+				if (!canWalkTo(creature, waypoint)) {
+					pathGraph.onRefineFailure();
+					return false;
+				}
+
+				steps.push_back(getDirectionTo(pos, waypoint));
+				pos = waypoint;
+				continue;
+			}
+		}
+
+		stretch.clear();
+		if (!findPath(walker, pos, stretch, FrozenPathingConditionCall(waypoint), last ? fpp : stretchParams)) {
+			pathGraph.onRefineFailure();
+			return false;
+		}
+
+		// findPath lists the steps from the end
+		steps.insert(steps.end(), stretch.rbegin(), stretch.rend());
+		pos = waypoint;
+	}
+
+	dirList.assign(steps.rbegin(), steps.rend());
+	return true;
+}
+
+// the part of Player::canWalkthrough that does not depend on the player trying to walk
+// into the same creature again, tiles it lets through are checked again by canWalkTo
+static bool isOccupiedForPlayer(const PlayerConstPtr& player, const CreatureVector& creatures)
+{
+	if (player->isAccessPlayer()) {
+		return false;
+	}
+
+	const bool allowWalkthrough = g_config.getBoolean(ConfigManager::ALLOW_WALKTHROUGH);
+	return std::ranges::any_of(creatures, [allowWalkthrough](const auto& tileCreature) {
+		if (tileCreature->isInGhostMode()) {
+			return false;
+		}
+
+		const auto& tilePlayer = tileCreature->getPlayer();
+		return !(allowWalkthrough && tilePlayer && tilePlayer->isAccessPlayer());
+	});
+}
+
+bool Map::captureWalkability(CreaturePtr& creature, const Position& targetPos, const FindPathParams& fpp, WalkabilitySnapshot& snapshot)
+{
+	const Position& startPos = creature->getPosition();
+
+	// the node budget keeps unbounded searches close to the start, a window cut short
+	// of maxSearchDist is searched again on the dispatcher if the path runs into its edge
+	const int32_t radius = std::min<int32_t>(fpp.maxSearchDist != 0 ? fpp.maxSearchDist : WalkabilitySnapshot::DEFAULT_RADIUS, WalkabilitySnapshot::MAX_RADIUS);
+	int32_t minX = startPos.x - radius;
+	int32_t minY = startPos.y - radius;
+	int32_t maxX = startPos.x + radius;
+	int32_t maxY = startPos.y + radius;
+
+	// sight lines run towards the target, farther than one tile they cross other tiles
+	const bool needsSight = fpp.clearSight && fpp.maxTargetDist > 1;
+	if (needsSight) {
+		minX = std::min<int32_t>(minX, targetPos.x);
+		minY = std::min<int32_t>(minY, targetPos.y);
+		maxX = std::max<int32_t>(maxX, targetPos.x);
+		maxY = std::max<int32_t>(maxY, targetPos.y);
+	}
+
+	minX = std::max<int32_t>(minX, 0);
+	minY = std::max<int32_t>(minY, 0);
+	maxX = std::min<int32_t>(maxX, std::numeric_limits<uint16_t>::max());
+	maxY = std::min<int32_t>(maxY, std::numeric_limits<uint16_t>::max());
+
+	const int32_t width = maxX - minX + 1;
+	const int32_t height = maxY - minY + 1;
+	if (width * height > WalkabilitySnapshot::MAX_TILES) {
+		return false;
+	}
+
+	snapshot.origin = Position(minX, minY, startPos.z);
+	snapshot.width = width;
+	snapshot.height = height;
+	snapshot.walkCosts.assign(width * height, WalkabilitySnapshot::BLOCKED);
+	snapshot.clearTiles.clear();
+	if (needsSight) {
+		snapshot.clearTiles.assign(width * height, true);
+	}
+
+	// Only tile flags, the shared passability layers and players blocking players are
+	// read here, the rest of queryAdd that depends on the creature (creatures that move
+	// away, houses, pz locks) is left to PathfindingPool, which checks every step of the
+	// path it gets back.
+	const bool useLayers = creature->useCacheMap();
+	const uint8_t movementClass = creature->getMovementClass();
+	const auto& player = creature->getPlayer();
+	const bool isPlayer = player != nullptr;
+
+	for (int32_t y = 0; y < height; ++y) {
+		const uint16_t tileY = minY + y;
+		for (int32_t x = 0; x < width;) {
+			const uint16_t tileX = minX + x;
+			// the rest of this row inside the current 8x8 floor
+			const int32_t runEnd = std::min<int32_t>(width, x + FLOOR_SIZE - (tileX & FLOOR_MASK));
+
+			QTreeLeafNode* leaf = getQTNode(tileX, tileY);
+			Floor* floor = leaf ? leaf->getFloor(startPos.z) : nullptr;
+			if (!floor) {
+				x = runEnd;
+				continue;
+			}
+
+			const uint64_t passable = useLayers ? floor->getPassableTiles(movementClass) : 0;
+			for (; x < runEnd; ++x) {
+				const uint32_t offsetX = (minX + x) & FLOOR_MASK;
+				const uint32_t offsetY = tileY & FLOOR_MASK;
+				const size_t index = y * width + x;
+				if (needsSight) {
+					snapshot.clearTiles[index] = (floor->projectileBlocking & (uint64_t{1} << (offsetX * FLOOR_SIZE + offsetY))) == 0;
+				}
+
+				const TilePtr& tile = floor->tiles[offsetX][offsetY];
+				if (!tile || !tile->getGround()) {
+					continue;
+				}
+
+				int16_t cost = 0;
+				if (useLayers) {
+					if ((passable & (uint64_t{1} << (offsetX * FLOOR_SIZE + offsetY))) == 0) {
+						continue;
+					}
+
+					if (tile->hasFlag(TILESTATE_MAGICFIELD)) {
+						cost = static_cast<int16_t>(AStarNodes::getTileWalkCost(creature, tile));
+					}
+				} else {
+					if (tile->hasFlag(TILESTATE_FLOORCHANGE | TILESTATE_TELEPORT | TILESTATE_BLOCKSOLID)) {
+						continue;
+					}
+
+					// autowalking players do not step on fields that would hurt them
+					if (isPlayer && tile->hasFlag(TILESTATE_MAGICFIELD)) {
+						const auto field = tile->getFieldItem();
+						if (field && field->getDamage() != 0) {
+							continue;
+						}
+					}
+				}
+
+				if (const auto& creatures = tile->getCreatures(); creatures && !creatures->empty()) {
+					// players do not walk through others, as in Tile::queryAdd
+					if (isPlayer && isOccupiedForPlayer(player, *creatures)) {
+						continue;
+					}
+
+					//destroy creature cost
+					cost += MAP_NORMALWALKCOST * 3;
+				}
+				snapshot.walkCosts[index] = cost;
+			}
+		}
+	}
+
+	// a creature can always stand where it is
+	if (snapshot.contains(startPos.x, startPos.y, startPos.z)) {
+		snapshot.walkCosts[(startPos.y - minY) * width + (startPos.x - minX)] = 0;
+	}
+	return true;
+}
+
+bool Map::isPathWalkable(CreaturePtr& creature, Position pos, const std::vector<Direction>& dirList)
+{
+	// the first step is the last one in the list
+	for (auto it = dirList.rbegin(); it != dirList.rend(); ++it) {
+		pos = getNextPosition(*it, pos);
+		if (!canWalkTo(creature, pos)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// FlowField
+
+static uint8_t getFieldMovementClass(const CombatType_t combatType)
+{
+	switch (combatType) {
+		case COMBAT_FIREDAMAGE:
+			return MOVEMENTCLASS_FIRE;
+		case COMBAT_ENERGYDAMAGE:
+			return MOVEMENTCLASS_ENERGY;
+		case COMBAT_EARTHDAMAGE:
+			return MOVEMENTCLASS_POISON;
+		default:
+			return MOVEMENTCLASS_NONE;
+	}
+}
+
+// the fields AStarNodes::getTileWalkCost charges this monster for, as movement class bits
+static uint8_t getFlowFieldPenalties(const MonsterConstPtr& monster)
+{
+	uint8_t penalties = MOVEMENTCLASS_NONE;
+	for (const CombatType_t combatType : {COMBAT_FIREDAMAGE, COMBAT_ENERGYDAMAGE, COMBAT_EARTHDAMAGE}) {
+		if (!monster->isImmune(combatType) && !monster->hasCondition(Combat::DamageToConditionType(combatType)) && !monster->canWalkOnFieldType(combatType)) {
+			penalties |= getFieldMovementClass(combatType);
+		}
+	}
+	return penalties;
+}
+
+bool Map::getFlowFieldPath(CreaturePtr& creature, const CreatureConstPtr& target, std::vector<Direction>& dirList)
+{
+	const Position& startPos = creature->getPosition();
+	const Position& targetPos = target->getPosition();
+	if (startPos.z != targetPos.z || Position::getDistanceX(startPos, targetPos) > FlowField::RADIUS || Position::getDistanceY(startPos, targetPos) > FlowField::RADIUS) {
+		++flowFieldStats.fallbacks;
+		return false;
+	}
+
+	const auto& monster = creature->getMonster();
+	if (!monster) {
+		++flowFieldStats.fallbacks;
+		return false;
+	}
+
+	const FlowField& field = getFlowField(targetPos, target->getID(), creature->getMovementClass(), getFlowFieldPenalties(monster));
+
+	int32_t x = startPos.x - targetPos.x + FlowField::RADIUS;
+	int32_t y = startPos.y - targetPos.y + FlowField::RADIUS;
+	uint32_t distance = field.distances[y * FlowField::SIZE + x];
+	if (distance == FlowField::UNREACHABLE) {
+		++flowFieldStats.fallbacks;
+		return false;
+	}
+
+	static constexpr int32_t neighbors[8][2] = {
+		{-1, 0}, {0, 1}, {1, 0}, {0, -1}, {-1, -1}, {1, -1}, {1, 1}, {-1, 1}
+	};
+
+	Position pos = startPos;
+	while (distance != 0) {
+		uint32_t bestCost = FlowField::UNREACHABLE;
+		int32_t bestX = 0;
+		int32_t bestY = 0;
+		for (const auto& [offsetX, offsetY] : neighbors) {
+			const int32_t nx = x + offsetX;
+			const int32_t ny = y + offsetY;
+			if (nx < 0 || ny < 0 || nx >= FlowField::SIZE || ny >= FlowField::SIZE) {
+				continue;
+			}
+
+			const int32_t index = ny * FlowField::SIZE + nx;
+			if (field.distances[index] >= distance) {
+				continue;
+			}
+
+			const uint32_t cost = field.distances[index] + field.tileCosts[index] + (offsetX != 0 && offsetY != 0 ? MAP_DIAGONALWALKCOST : MAP_NORMALWALKCOST);
+			if (cost >= bestCost) {
+				continue;
+			}
+
+			// creatures only matter for the step taken right now
+			if (dirList.empty() && !canWalkTo(creature, Position(pos.x + offsetX, pos.y + offsetY, pos.z))) {
+				continue;
+			}
+
+			bestCost = cost;
+			bestX = offsetX;
+			bestY = offsetY;
+		}
+
+		if (bestCost == FlowField::UNREACHABLE) {
+			dirList.clear();
+			++flowFieldStats.fallbacks;
+			return false;
+		}
+
+		const Position nextPos(pos.x + bestX, pos.y + bestY, pos.z);
+		dirList.push_back(getDirectionTo(pos, nextPos));
+		pos = nextPos;
+		x += bestX;
+		y += bestY;
+		distance = field.distances[y * FlowField::SIZE + x];
+	}
+
+	// walking takes the directions from the back
+	std::reverse(dirList.begin(), dirList.end());
+	++flowFieldStats.searchesAvoided;
+	return true;
+}
+
+void Map::onTilePathingChange(const Position& pos)
+{
+	if (QTreeLeafNode* leaf = getQTNode(pos.x, pos.y)) {
+		++leaf->tileVersion;
+		if (Floor* floor = leaf->getFloor(pos.z)) {
+			floor->resetPassability();
+		}
+	}
+	pathGraph.invalidate(pos);
+}
+
+void Map::onTileSightChange(const Position& pos)
+{
+	++sightEpoch;
+
+	QTreeLeafNode* leaf = getQTNode(pos.x, pos.y);
+	if (!leaf) {
+		return;
+	}
+
+	Floor* floor = leaf->getFloor(pos.z);
+	if (!floor) {
+		return;
+	}
+
+	const uint64_t bit = uint64_t{1} << ((pos.x & FLOOR_MASK) * FLOOR_SIZE + (pos.y & FLOOR_MASK));
+	if (const auto& tile = floor->tiles[pos.x & FLOOR_MASK][pos.y & FLOOR_MASK]; tile && tile->hasFlag(TILESTATE_BLOCKPROJECTILE)) {
+		floor->projectileBlocking |= bit;
+	} else {
+		floor->projectileBlocking &= ~bit;
+	}
+}
+
+const FlowField& Map::getFlowField(const Position& targetPos, const uint32_t targetId, const uint8_t movementClass, const uint8_t fieldPenalties)
+{
+	// monsters that walk and weigh fields alike share a field
+	const uint64_t key = (static_cast<uint64_t>(targetId) << 8) | (movementClass << 4) | fieldPenalties;
+
+	++flowFieldTick;
+	if (auto it = flowFields.find(key); it != flowFields.end()) {
+		FlowField& field = it->second;
+		if (!isFlowFieldValid(field, targetPos)) {
+			buildFlowField(field, targetPos, movementClass, fieldPenalties);
+		}
+		field.lastUse = flowFieldTick;
+		return field;
+	}
+
+	if (flowFields.size() >= MAX_FLOW_FIELDS) {
+		evictFlowFields();
+	}
+
+	FlowField& field = flowFields[key];
+	buildFlowField(field, targetPos, movementClass, fieldPenalties);
+	field.lastUse = flowFieldTick;
+	return field;
+}
+
+void Map::buildFlowField(FlowField& field, const Position& targetPos, const uint8_t movementClass, const uint8_t fieldPenalties)
+{
+	++flowFieldStats.fieldsBuilt;
+
+	field.targetPos = targetPos;
+	field.leafGeneration = QTreeLeafNode::leafGeneration;
+	field.leafVersions.clear();
+	field.distances.fill(FlowField::UNREACHABLE);
+
+	const int32_t baseX = targetPos.x - FlowField::RADIUS;
+	const int32_t baseY = targetPos.y - FlowField::RADIUS;
+	for (int32_t y = 0; y < FlowField::SIZE; ++y) {
+		for (int32_t x = 0; x < FlowField::SIZE; ++x) {
+			const int32_t tileX = baseX + x;
+			const int32_t tileY = baseY + y;
+			uint32_t& tileCost = field.tileCosts[y * FlowField::SIZE + x];
+			tileCost = FlowField::UNREACHABLE;
+			if (tileX < 0 || tileY < 0 || tileX > std::numeric_limits<uint16_t>::max() || tileY > std::numeric_limits<uint16_t>::max()) {
+				continue;
+			}
+
+			// the same layers canWalkTo reads, creatures on the tile are left to the first step
+			QTreeLeafNode* leaf = getQTNode(tileX, tileY);
+			Floor* floor = leaf ? leaf->getFloor(targetPos.z) : nullptr;
+			const uint64_t bit = uint64_t{1} << ((tileX & FLOOR_MASK) * FLOOR_SIZE + (tileY & FLOOR_MASK));
+			if (!floor || (floor->getPassableTiles(movementClass) & bit) == 0) {
+				continue;
+			}
+
+			tileCost = 0;
+			if (const auto& tile = floor->tiles[tileX & FLOOR_MASK][tileY & FLOOR_MASK]; tile->hasFlag(TILESTATE_MAGICFIELD)) {
+				if (const auto& fieldItem = tile->getFieldItem(); fieldItem && (getFieldMovementClass(fieldItem->getCombatType()) & fieldPenalties) != 0) {
+					tileCost = MAP_NORMALWALKCOST * 18;
+				}
+			}
+		}
+	}
+
+	// the target stands on its own tile
+	field.tileCosts[FlowField::RADIUS * FlowField::SIZE + FlowField::RADIUS] = FlowField::UNREACHABLE;
+
+	for (int32_t y = std::max<int32_t>(0, baseY) & ~FLOOR_MASK; y < baseY + FlowField::SIZE; y += FLOOR_SIZE) {
+		for (int32_t x = std::max<int32_t>(0, baseX) & ~FLOOR_MASK; x < baseX + FlowField::SIZE; x += FLOOR_SIZE) {
+			if (const QTreeLeafNode* leaf = getQTNode(x, y)) {
+				field.leafVersions.emplace_back(leaf, leaf->tileVersion);
+			}
+		}
+	}
+
+	// dijkstra outwards from every walkable tile next to the target
+	using QueueEntry = std::pair<uint32_t, int32_t>;
+	std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<>> queue;
+	for (int32_t y = FlowField::RADIUS - 1; y <= FlowField::RADIUS + 1; ++y) {
+		for (int32_t x = FlowField::RADIUS - 1; x <= FlowField::RADIUS + 1; ++x) {
+			const int32_t index = y * FlowField::SIZE + x;
+			if (field.tileCosts[index] != FlowField::UNREACHABLE) {
+				field.distances[index] = 0;
+				queue.emplace(0, index);
+			}
+		}
+	}
+
+	while (!queue.empty()) {
+		const auto [distance, index] = queue.top();
+		queue.pop();
+		if (distance != field.distances[index]) {
+			continue;
+		}
+
+		// stepping onto this tile from a neighbour costs the step and the tile
+		const int32_t x = index % FlowField::SIZE;
+		const int32_t y = index / FlowField::SIZE;
+		for (int32_t offsetY = -1; offsetY <= 1; ++offsetY) {
+			for (int32_t offsetX = -1; offsetX <= 1; ++offsetX) {
+				const int32_t nx = x + offsetX;
+				const int32_t ny = y + offsetY;
+				if ((offsetX == 0 && offsetY == 0) || nx < 0 || ny < 0 || nx >= FlowField::SIZE || ny >= FlowField::SIZE) {
+					continue;
+				}
+
+				const int32_t neighborIndex = ny * FlowField::SIZE + nx;
+				if (field.tileCosts[neighborIndex] == FlowField::UNREACHABLE) {
+					continue;
+				}
+
+				const uint32_t newDistance = distance + field.tileCosts[index] + (offsetX != 0 && offsetY != 0 ? MAP_DIAGONALWALKCOST : MAP_NORMALWALKCOST);
+				if (newDistance < field.distances[neighborIndex]) {
+					field.distances[neighborIndex] = newDistance;
+					queue.emplace(newDistance, neighborIndex);
+				}
+			}
+		}
+	}
+}
+
+bool Map::isFlowFieldValid(const FlowField& field, const Position& targetPos)
+{
+	if (field.targetPos != targetPos || field.leafGeneration != QTreeLeafNode::leafGeneration) {
+		return false;
+	}
+
+	return std::ranges::all_of(field.leafVersions, [](const auto& leafVersion) {
+		const auto& [leaf, version] = leafVersion;
+		return leaf->tileVersion == version;
+	});
+}
+
+void Map::evictFlowFields()
+{
+	// same policy as the spectator cache, targets that went away stop being used
+	const uint64_t threshold = flowFieldTick > MAX_FLOW_FIELDS / 2 ? flowFieldTick - MAX_FLOW_FIELDS / 2 : 0;
+	for (auto it = flowFields.begin(); it != flowFields.end();) {
+		if (it->second.lastUse < threshold) {
+			flowFields.erase(it++);
+		} else {
+			++it;
+		}
+	}
+}
+
 // AStarNodes
 
 AStarNodes::AStarNodes(uint32_t x, uint32_t y)
-	: nodes(), openNodes()
 {
 	curNode = 1;
 	closedNodes = 0;
-	openNodes[0] = true;
+	std::fill(std::begin(nodeIndexes), std::end(nodeIndexes), -1);
 
 	AStarNode& startNode = nodes[0];
 	startNode.parent = nullptr;
 	startNode.x = x;
 	startNode.y = y;
 	startNode.f = 0;
-	nodeTable[(x << 16) | y] = nodes;
+	addNodeIndex(x, y, 0);
+	pushOpenNode(0);
 }
 
 AStarNode* AStarNodes::createOpenNode(AStarNode* parent, uint32_t x, uint32_t y, int_fast32_t f)
@@ -871,44 +1622,42 @@ AStarNode* AStarNodes::createOpenNode(AStarNode* parent, uint32_t x, uint32_t y,
 		return nullptr;
 	}
 
-	const size_t retNode = curNode++;
-	openNodes[retNode] = true;
+	const auto retNode = static_cast<int16_t>(curNode++);
+	addNodeIndex(x, y, retNode);
 
 	AStarNode* node = nodes + retNode;
-	nodeTable[(x << 16) | y] = node;
 	node->parent = parent;
 	node->x = x;
 	node->y = y;
 	node->f = f;
+	pushOpenNode(retNode);
 	return node;
 }
 
 AStarNode* AStarNodes::getBestNode()
 {
-	if (curNode == 0) {
+	if (openCount == 0) {
 		return nullptr;
 	}
-
-	int32_t best_node_f = std::numeric_limits<int32_t>::max();
-	int32_t best_node = -1;
-	for (size_t i = 0; i < curNode; i++) {
-		if (openNodes[i] && nodes[i].f < best_node_f) {
-			best_node_f = nodes[i].f;
-			best_node = i;
-		}
-	}
-
-	if (best_node >= 0) {
-		return nodes + best_node;
-	}
-	return nullptr;
+	return nodes + openHeap[0];
 }
 
 void AStarNodes::closeNode(const AStarNode* node)
 {
 	size_t index = node - nodes;
 	assert(index < MAX_NODES);
-	openNodes[index] = false;
+
+	const int16_t heapIndex = heapPositions[index];
+	if (heapIndex >= 0) {
+		heapPositions[index] = -1;
+		if (heapIndex != --openCount) {
+			const int16_t moved = openHeap[openCount];
+			openHeap[heapIndex] = moved;
+			heapPositions[moved] = heapIndex;
+			siftDown(heapIndex);
+			siftUp(heapPositions[moved]);
+		}
+	}
 	++closedNodes;
 }
 
@@ -916,10 +1665,76 @@ void AStarNodes::openNode(const AStarNode* node)
 {
 	size_t index = node - nodes;
 	assert(index < MAX_NODES);
-	if (!openNodes[index]) {
-		openNodes[index] = true;
+	if (heapPositions[index] < 0) {
+		pushOpenNode(static_cast<int16_t>(index));
 		--closedNodes;
+	} else {
+		// the caller only ever lowers f of an open node
+		siftUp(heapPositions[index]);
+	}
+}
+
+void AStarNodes::addNodeIndex(const uint32_t x, const uint32_t y, const int16_t index)
+{
+	const uint32_t key = getNodeKey(x, y);
+	uint32_t slot = getNodeSlot(key);
+	while (nodeIndexes[slot] != -1) {
+		slot = (slot + 1) & (NODE_TABLE_SIZE - 1);
+	}
+	nodeKeys[slot] = key;
+	nodeIndexes[slot] = index;
+}
+
+void AStarNodes::pushOpenNode(const int16_t index)
+{
+	const int16_t heapIndex = openCount++;
+	openHeap[heapIndex] = index;
+	heapPositions[index] = heapIndex;
+	siftUp(heapIndex);
+}
+
+void AStarNodes::siftUp(int16_t heapIndex)
+{
+	const int16_t index = openHeap[heapIndex];
+	while (heapIndex > 0) {
+		const int16_t parentIndex = (heapIndex - 1) / 2;
+		const int16_t parent = openHeap[parentIndex];
+		if (!isBetterNode(index, parent)) {
+			break;
+		}
+
+		openHeap[heapIndex] = parent;
+		heapPositions[parent] = heapIndex;
+		heapIndex = parentIndex;
+	}
+	openHeap[heapIndex] = index;
+	heapPositions[index] = heapIndex;
+}
+
+void AStarNodes::siftDown(int16_t heapIndex)
+{
+	const int16_t index = openHeap[heapIndex];
+	while (true) {
+		int16_t childIndex = heapIndex * 2 + 1;
+		if (childIndex >= openCount) {
+			break;
+		}
+
+		if (childIndex + 1 < openCount && isBetterNode(openHeap[childIndex + 1], openHeap[childIndex])) {
+			++childIndex;
+		}
+
+		const int16_t child = openHeap[childIndex];
+		if (!isBetterNode(child, index)) {
+			break;
+		}
+
+		openHeap[heapIndex] = child;
+		heapPositions[child] = heapIndex;
+		heapIndex = childIndex;
 	}
+	openHeap[heapIndex] = index;
+	heapPositions[index] = heapIndex;
 }
 
 int_fast32_t AStarNodes::getClosedNodes() const
@@ -929,11 +1744,13 @@ int_fast32_t AStarNodes::getClosedNodes() const
 
 AStarNode* AStarNodes::getNodeByPosition(const uint32_t x, const uint32_t y)
 {
-	auto it = nodeTable.find((x << 16) | y);
-	if (it == nodeTable.end()) {
-		return nullptr;
+	const uint32_t key = getNodeKey(x, y);
+	for (uint32_t slot = getNodeSlot(key); nodeIndexes[slot] != -1; slot = (slot + 1) & (NODE_TABLE_SIZE - 1)) {
+		if (nodeKeys[slot] == key) {
+			return nodes + nodeIndexes[slot];
+		}
 	}
-	return it->second;
+	return nullptr;
 }
 
 int_fast32_t AStarNodes::getMapWalkCost(const AStarNode* node, const Position& neighborPos)
@@ -970,6 +1787,99 @@ Floor::~Floor()
 			tile.reset();
 		}
 	}
+	delete passability.load(std::memory_order_relaxed);
+}
+
+uint64_t Floor::getPassableTiles(const uint8_t movementClass)
+{
+	PassabilityLayers* layers = passability.load(std::memory_order_acquire);
+	if (!layers) {
+		auto created = new PassabilityLayers();
+		if (passability.compare_exchange_strong(layers, created, std::memory_order_acq_rel)) {
+			layers = created;
+		} else {
+			// another worker was first, layers holds its copy now
+			delete created;
+		}
+	}
+
+	const uint16_t classBit = 1 << movementClass;
+	if ((layers->built.load(std::memory_order_acquire) & classBit) != 0) {
+		return layers->tiles[movementClass].load(std::memory_order_relaxed);
+	}
+
+	// racing workers work out the same bits
+	uint64_t passable = 0;
+	for (int32_t x = 0; x < FLOOR_SIZE; ++x) {
+		for (int32_t y = 0; y < FLOOR_SIZE; ++y) {
+			if (const auto& tile = tiles[x][y]; tile && tile->isPassableFor(movementClass)) {
+				passable |= uint64_t{1} << (x * FLOOR_SIZE + y);
+			}
+		}
+	}
+
+	layers->tiles[movementClass].store(passable, std::memory_order_relaxed);
+	layers->built.fetch_or(classBit, std::memory_order_release);
+	return passable;
+}
+
+// TileArena
+TileArena& TileArena::getFloor(const uint8_t z)
+{
+	// intentionally leaked, tiles may still be released while other globals are destroyed
+	static auto* arenas = new TileArena[MAP_MAX_LAYERS];
+	return arenas[std::min<uint8_t>(z, MAP_MAX_LAYERS - 1)];
+}
+
+TilePtr TileArena::createTile(const uint16_t x, const uint16_t y, const uint8_t z, House* house/* = nullptr*/)
+{
+	return std::allocate_shared<Tile>(TileArenaAllocator<Tile>(z), x, y, z, house);
+}
+
+void* TileArena::allocate(const size_t size, const size_t alignment)
+{
+	std::lock_guard<std::mutex> lockGuard(mutex);
+
+	size_t offset = (chunkOffset + alignment - 1) & ~(alignment - 1);
+	if (offset + size > CHUNK_SIZE) {
+		if (size > CHUNK_SIZE) {
+			throw std::bad_alloc();
+		}
+
+		chunks.emplace_back(new std::byte[CHUNK_SIZE]);
+		offset = 0;
+	}
+
+	chunkOffset = offset + size;
+	allocatedBytes += size;
+	++allocations;
+	return chunks.back().get() + offset;
+}
+
+void Map::setLeafGrid(const bool enabled)
+{
+	if (QTreeLeafNode::leafGeneration != 0) {
+		std::cout << "[Warning - Map::setLeafGrid] The map backend can not be changed once tiles are loaded." << std::endl;
+		return;
+	}
+	useLeafGrid = enabled;
+}
+
+// LeafGrid
+void LeafGrid::set(const uint16_t x, const uint16_t y, QTreeLeafNode* leaf)
+{
+	if (directory.empty()) {
+		directory.resize(DIRECTORY_SIZE * DIRECTORY_SIZE);
+	}
+
+	const uint32_t leafX = x >> FLOOR_BITS;
+	const uint32_t leafY = y >> FLOOR_BITS;
+	auto& page = directory[(leafY >> PAGE_BITS) * DIRECTORY_SIZE + (leafX >> PAGE_BITS)];
+	if (!page) {
+		page = std::make_unique<Page>();
+		page->fill(nullptr);
+	}
+	(*page)[(leafY & PAGE_MASK) * PAGE_SIZE + (leafX & PAGE_MASK)] = leaf;
 }
 
 // QTreeNode
@@ -1012,6 +1922,7 @@ QTreeLeafNode* QTreeNode::createLeaf(const uint32_t x, const uint32_t y, const u
 
 // QTreeLeafNode
 bool QTreeLeafNode::newLeaf = false;
+uint32_t QTreeLeafNode::leafGeneration = 0;
 
 QTreeLeafNode::~QTreeLeafNode()
 {
@@ -1031,9 +1942,11 @@ Floor* QTreeLeafNode::createFloor(const uint32_t z)
 void QTreeLeafNode::addCreature(const CreaturePtr& c)
 {
 	creature_list.push_back(c);
+	++creatureVersion;
 
 	if (c->getPlayer()) {
 		player_list.push_back(c);
+		++playerVersion;
 	}
 }
 
@@ -1043,17 +1956,28 @@ void QTreeLeafNode::removeCreature(const CreaturePtr& c)
 	assert(iter != creature_list.end());
 	*iter = creature_list.back();
 	creature_list.pop_back();
+	++creatureVersion;
 
 	if (c->getPlayer()) {
 		iter = std::ranges::find(player_list, c);
 		assert(iter != player_list.end());
 		*iter = player_list.back();
 		player_list.pop_back();
+		++playerVersion;
+	}
+}
+
+void QTreeLeafNode::onCreatureMove(const CreaturePtr& c)
+{
+	++creatureVersion;
+	if (c->getPlayer()) {
+		++playerVersion;
 	}
 }
 
 uint32_t Map::clean()
 {
+	DispatcherProfiler::Scope profile(g_dispatcher.getProfiler(), "Map::clean");
 	const uint64_t start = OTSYS_TIME();
 	size_t tiles = 0;
 
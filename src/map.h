@@ -13,8 +13,10 @@
 #include "town.h"
 #include "house.h"
 #include "spawn.h"
+#include "pathgraph.h"
 
 #include <gtl/phmap.hpp>
+#include <atomic>
 
 class Creature;
 class Player;
@@ -76,8 +78,6 @@ struct ChunkKeyEqual {
 	}
 };
 
-using ChunkCache = gtl::node_hash_map<ChunkKey, SpectatorVec, ChunkKeyHash, ChunkKeyEqual>;
-
 class AStarNodes
 {
 	public:
@@ -94,19 +94,114 @@ class AStarNodes
 		static int_fast32_t getTileWalkCost(const CreaturePtr creature, const TileConstPtr& tile);
 
 	private:
+		// open-addressing table from position to node index, twice the node budget keeps probes short
+		static constexpr uint32_t NODE_TABLE_BITS = 10;
+		static constexpr uint32_t NODE_TABLE_SIZE = 1 << NODE_TABLE_BITS;
+		static_assert(NODE_TABLE_SIZE >= MAX_NODES * 2);
+
+		static uint32_t getNodeKey(uint32_t x, uint32_t y) {
+			return (x << 16) | y;
+		}
+		static uint32_t getNodeSlot(uint32_t key) {
+			return (key * 0x9E3779B1) >> (32 - NODE_TABLE_BITS);
+		}
+		void addNodeIndex(uint32_t x, uint32_t y, int16_t index);
+
+		// min-heap of open node indexes ordered by f, ties go to the older node
+		bool isBetterNode(int16_t lhs, int16_t rhs) const {
+			return nodes[lhs].f < nodes[rhs].f || (nodes[lhs].f == nodes[rhs].f && lhs < rhs);
+		}
+		void pushOpenNode(int16_t index);
+		void siftUp(int16_t heapIndex);
+		void siftDown(int16_t heapIndex);
+
 		AStarNode nodes[MAX_NODES];
-		bool openNodes[MAX_NODES];
-		gtl::node_hash_map<uint32_t, AStarNode*> nodeTable;
+		int16_t heapPositions[MAX_NODES]; // -1 while the node is closed
+		int16_t openHeap[MAX_NODES];
+		int16_t openCount = 0;
+
+		uint32_t nodeKeys[NODE_TABLE_SIZE];
+		int16_t nodeIndexes[NODE_TABLE_SIZE];
+
 		size_t curNode;
 		int_fast32_t closedNodes;
 };
 
-using SpectatorCache = std::map<Position, SpectatorVec>;
-
 static constexpr int32_t FLOOR_BITS = 3;
 static constexpr int32_t FLOOR_SIZE = (1 << FLOOR_BITS);
 static constexpr int32_t FLOOR_MASK = (FLOOR_SIZE - 1);
 
+// Bump allocator for the tiles loaded with the map, one per floor so the tiles of a
+// floor (and their shared_ptr control blocks) are packed next to each other. The
+// memory is never handed back, map tiles live as long as the server does.
+class TileArena
+{
+	public:
+		static TileArena& getFloor(uint8_t z);
+
+		static TilePtr createTile(uint16_t x, uint16_t y, uint8_t z, House* house = nullptr);
+
+		void* allocate(size_t size, size_t alignment);
+
+		size_t getAllocatedBytes() const {
+			return allocatedBytes;
+		}
+
+		size_t getReservedBytes() const {
+			return chunks.size() * CHUNK_SIZE;
+		}
+
+		size_t getAllocations() const {
+			return allocations;
+		}
+
+	private:
+		static constexpr size_t CHUNK_SIZE = 1 << 20;
+
+		std::mutex mutex;
+		std::vector<std::unique_ptr<std::byte[]>> chunks;
+		size_t chunkOffset = CHUNK_SIZE;
+		size_t allocatedBytes = 0;
+		size_t allocations = 0;
+};
+
+template <typename T>
+class TileArenaAllocator
+{
+	public:
+		using value_type = T;
+
+		explicit TileArenaAllocator(uint8_t z) : z(z) {}
+
+		template <typename U>
+		TileArenaAllocator(const TileArenaAllocator<U>& other) : z(other.z) {}
+
+		T* allocate(size_t n) {
+			return static_cast<T*>(TileArena::getFloor(z).allocate(n * sizeof(T), alignof(T)));
+		}
+
+		void deallocate(T*, size_t) {}
+
+		template <typename U>
+		bool operator==(const TileArenaAllocator<U>& other) const {
+			return z == other.z;
+		}
+
+	private:
+		uint8_t z;
+
+		template <typename U>
+		friend class TileArenaAllocator;
+};
+
+// Which tiles of a floor monsters of each movement class can walk on, one bit per tile
+// in tiles[x][y] order. A class is worked out on first use, which may be on the follow
+// path workers, and all of them are thrown away when a tile changes its walkability.
+struct PassabilityLayers {
+	std::atomic<uint64_t> tiles[MOVEMENTCLASS_COUNT] = {};
+	std::atomic<uint16_t> built{0};
+};
+
 struct Floor {
 	constexpr Floor() = default;
 	~Floor();
@@ -115,7 +210,18 @@ struct Floor {
 	Floor(const Floor&) = delete;
 	Floor& operator=(const Floor&) = delete;
 
+	uint64_t getPassableTiles(uint8_t movementClass);
+
+	// dispatcher only, while no worker reads the layers
+	void resetPassability() {
+		if (PassabilityLayers* layers = passability.load(std::memory_order_relaxed)) {
+			layers->built.store(0, std::memory_order_relaxed);
+		}
+	}
+
 	TilePtr tiles[FLOOR_SIZE][FLOOR_SIZE] = {};
+	std::atomic<PassabilityLayers*> passability{nullptr}; // created on first use
+	uint64_t projectileBlocking = 0; // tiles with TILESTATE_BLOCKPROJECTILE, same bit order as the passability layers
 };
 
 class FrozenPathingConditionCall;
@@ -170,7 +276,7 @@ class QTreeNode
 class QTreeLeafNode final : public QTreeNode
 {
 	public:
-		QTreeLeafNode() { leaf = true; newLeaf = true; }
+		QTreeLeafNode() { leaf = true; newLeaf = true; ++leafGeneration; }
 		~QTreeLeafNode() override;
 
 		// non-copyable
@@ -186,8 +292,30 @@ class QTreeLeafNode final : public QTreeNode
 		void addCreature(const CreaturePtr& c);
 		void removeCreature(const CreaturePtr& c);
 
+		// a creature moved inside the leaf, cached spectators around it are outdated
+		void onCreatureMove(const CreaturePtr& c);
+
+		uint32_t getCreatureVersion() const {
+			return creatureVersion;
+		}
+
+		uint32_t getPlayerVersion() const {
+			return playerVersion;
+		}
+
+		// bumped when a tile in the leaf changes whether or how it can be walked on
+		uint32_t getTileVersion() const {
+			return tileVersion;
+		}
+
+		// bumped whenever a leaf is created, a cached result can not know about new leaves
+		static uint32_t leafGeneration;
+
 	private:
 		static bool newLeaf;
+		uint32_t creatureVersion = 0;
+		uint32_t playerVersion = 0;
+		uint32_t tileVersion = 0;
 		QTreeLeafNode* leafS = nullptr;
 		QTreeLeafNode* leafE = nullptr;
 		Floor* array[MAP_MAX_LAYERS] = {};
@@ -198,6 +326,116 @@ class QTreeLeafNode final : public QTreeNode
 		friend class QTreeNode;
 };
 
+// Flat index over the quadtree leaves. A directory of 256x256 pages, each holding
+// 32x32 leaf pointers (256x256 tiles), finds the leaf of any position with two
+// array loads instead of walking up to 13 tree levels. The quadtree still owns
+// the leaves, the grid only indexes them.
+class LeafGrid
+{
+	public:
+		static constexpr uint32_t PAGE_BITS = 5;
+		static constexpr uint32_t PAGE_SIZE = 1 << PAGE_BITS;
+		static constexpr uint32_t PAGE_MASK = PAGE_SIZE - 1;
+		static constexpr uint32_t DIRECTORY_SIZE = 1 << (16 - FLOOR_BITS - PAGE_BITS);
+
+		QTreeLeafNode* get(uint16_t x, uint16_t y) const {
+			if (directory.empty()) {
+				return nullptr;
+			}
+
+			const uint32_t leafX = x >> FLOOR_BITS;
+			const uint32_t leafY = y >> FLOOR_BITS;
+			const auto& page = directory[(leafY >> PAGE_BITS) * DIRECTORY_SIZE + (leafX >> PAGE_BITS)];
+			if (!page) {
+				return nullptr;
+			}
+			return (*page)[(leafY & PAGE_MASK) * PAGE_SIZE + (leafX & PAGE_MASK)];
+		}
+
+		void set(uint16_t x, uint16_t y, QTreeLeafNode* leaf);
+
+	private:
+		using Page = std::array<QTreeLeafNode*, PAGE_SIZE * PAGE_SIZE>;
+
+		std::vector<std::unique_ptr<Page>> directory;
+};
+
+// A cached getSpectators result stays valid as long as none of the leaves it was
+// collected from had a creature (or, for player only queries, a player) added,
+// removed or moved since. The creatures are held weakly so entries that are never
+// looked up again do not keep removed creatures alive.
+struct SpectatorCacheEntry {
+	std::vector<std::weak_ptr<Creature>> spectators;
+	std::vector<std::pair<const QTreeLeafNode*, uint32_t>> leafVersions;
+	uint64_t lastUse = 0;
+	uint32_t leafGeneration = 0;
+};
+
+using ChunkCache = gtl::node_hash_map<ChunkKey, SpectatorCacheEntry, ChunkKeyHash, ChunkKeyEqual>;
+
+struct SpectatorCacheStats {
+	uint64_t hits = 0;
+	uint64_t misses = 0;
+	uint64_t evictions = 0;
+};
+
+// Walk costs from every tile around a target to the tiles next to it, shared by the
+// monsters chasing that target that walk and weigh fields alike. Creatures are left out as they move every step, the
+// first step taken from the field is checked against them.
+struct FlowField {
+	static constexpr int32_t RADIUS = 12;
+	static constexpr int32_t SIZE = RADIUS * 2 + 1;
+	static constexpr uint32_t UNREACHABLE = std::numeric_limits<uint32_t>::max();
+
+	std::array<uint32_t, SIZE * SIZE> distances;
+	std::array<uint32_t, SIZE * SIZE> tileCosts;
+	std::vector<std::pair<const QTreeLeafNode*, uint32_t>> leafVersions;
+	Position targetPos;
+	uint64_t lastUse = 0;
+	uint32_t leafGeneration = 0;
+};
+
+// Walkability of the tiles around a creature as its own searches see them, taken on the
+// dispatcher so that a path can be searched on another thread.
+struct WalkabilitySnapshot {
+	static constexpr int16_t BLOCKED = -1;
+	static constexpr int32_t DEFAULT_RADIUS = 8;
+	static constexpr int32_t MAX_RADIUS = 64;
+	// a full window around the start, or a smaller one stretched to a target in sight
+	static constexpr int32_t MAX_TILES = (MAX_RADIUS * 2 + 1) * (MAX_RADIUS * 2 + 1);
+
+	bool contains(uint16_t x, uint16_t y, uint8_t z) const {
+		return z == origin.z && x >= origin.x && y >= origin.y && x - origin.x < width && y - origin.y < height;
+	}
+
+	int16_t getWalkCost(uint16_t x, uint16_t y) const {
+		return walkCosts[(y - origin.y) * width + (x - origin.x)];
+	}
+
+	// only filled in when the search has to check line of sight
+	bool isTileClear(uint16_t x, uint16_t y) const {
+		return clearTiles.empty() || clearTiles[(y - origin.y) * width + (x - origin.x)];
+	}
+
+	Position origin;
+	int32_t width = 0;
+	int32_t height = 0;
+	std::vector<int16_t> walkCosts;
+	std::vector<bool> clearTiles;
+};
+
+struct FlowFieldStats {
+	uint64_t fieldsBuilt = 0;
+	uint64_t searchesAvoided = 0;
+	uint64_t fallbacks = 0;
+};
+
+struct TileStats {
+	uint64_t loaded = 0; // set from map files
+	uint64_t runtime = 0; // set afterwards, these stay in the map for good
+	uint64_t virtualTiles = 0; // handed out without ever being set
+};
+
 /**
   * Map class.
   * Holds all the actual map-data
@@ -219,11 +457,6 @@ class Map
 		  */
 		bool loadMap(const std::string& identifier, bool loadHouses);
 	
-		void clearChunkSpectatorCache()	{
-			playersSpectatorCache.clear();
-			chunksSpectatorCache.clear();
-		}
-
 		/**
 		  * Save a map.
 		  * \returns true if the map was saved successfully
@@ -258,6 +491,17 @@ class Map
 			removeTile(pos.x, pos.y, pos.z);
 		}
 
+		/**
+		  * Creates an empty tile for pos without setting it, for positions that only show
+		  * effects such as spell areas over the void. It has no ground, so nothing can be
+		  * added to it, and it is gone once the last reference to it is.
+		  */
+		TilePtr createVirtualTile(const Position& pos);
+
+		const TileStats& getTileStats() const {
+			return tileStats;
+		}
+
 		/**
 		  * Place a creature on the map
 		  * \param centerPos The position to place the creature
@@ -273,8 +517,13 @@ class Map
 		                   int32_t minRangeX = 0, int32_t maxRangeX = 0,
 		                   int32_t minRangeY = 0, int32_t maxRangeY = 0);
 
-		void clearSpectatorCache();
-		void clearPlayersSpectatorCache();
+		const SpectatorCacheStats& getSpectatorCacheStats() const {
+			return spectatorCacheStats;
+		}
+
+		size_t getSpectatorCacheSize() const {
+			return chunksSpectatorCache.size();
+		}
 
 		/**
 		  * Checks if you can throw an object to that position
@@ -307,25 +556,119 @@ class Map
 		bool isSightClear(const Position& fromPos, const Position& toPos, bool sameFloor = false);
 		static bool checkSightLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t z);
 
+		/**
+		  * isSightClear for callers asking about the same pairs over and over, such as monsters
+		  * checking their targets. Results are kept per thread until the next creature think
+		  * cycle or until a tile changes what it blocks, whichever comes first.
+		  */
+		bool isSightClearCached(const Position& fromPos, const Position& toPos, bool sameFloor = false);
+
+		// forgets the cached sight lines, called once every creature think cycle
+		void advanceSightTick() {
+			++sightEpoch;
+		}
+
 		TilePtr canWalkTo(CreaturePtr& creature, const Position& pos);
 
+		/**
+		  * Looks pos up in the passability layer of a movement class
+		  * \returns 0 if it can not be walked on, 1 if it can and 2 if creatures on it need a full check
+		  */
+		int32_t getWalkCache(const Position& pos, uint8_t movementClass);
+
 		bool getPathMatching(CreaturePtr& creature, std::vector<Direction>& dirList,
 		                     const FrozenPathingConditionCall& pathCondition, const FindPathParams& fpp);
 
+		/**
+		  * Searches a path on a snapshot instead of the map, safe on any thread
+		  * \param incomplete set if the search ran into the edge of the snapshot
+		  */
+		static bool getPathMatching(const WalkabilitySnapshot& snapshot, const Position& startPos, std::vector<Direction>& dirList,
+		                            const FrozenPathingConditionCall& pathCondition, const FindPathParams& fpp, bool& incomplete);
+
+		/**
+		  * Takes the walkability around creature that a search towards targetPos can read
+		  * \returns false if that area is too large to copy
+		  */
+		bool captureWalkability(CreaturePtr& creature, const Position& targetPos, const FindPathParams& fpp, WalkabilitySnapshot& snapshot);
+		// checks every step of a path searched on a snapshot against the map as it is now
+		bool isPathWalkable(CreaturePtr& creature, Position pos, const std::vector<Direction>& dirList);
+
+		/**
+		  * Walks the flow field of target down to a tile next to it
+		  * \returns false if the caller has to search the path itself
+		  */
+		bool getFlowFieldPath(CreaturePtr& creature, const CreatureConstPtr& target, std::vector<Direction>& dirList);
+
+		/**
+		  * Finds a path too long for getPathMatching through the path graph, the
+		  * stretches between its entrances are searched with getPathMatching
+		  * \returns false if the path graph is off or has no way there
+		  */
+		bool getHierarchicalPath(CreaturePtr& creature, const Position& targetPos, std::vector<Direction>& dirList, const FindPathParams& fpp);
+
+		// builds the path graph of the loaded map, hierarchical paths are off until then
+		void buildPathGraph(bool parallel) {
+			pathGraph.build(*this, width, height, parallel);
+		}
+
+		const PathGraph& getPathGraph() const {
+			return pathGraph;
+		}
+
+		// called by tiles when their walkability changes, outdates flow fields and path graph clusters over them
+		void onTilePathingChange(const Position& pos);
+
+		// called by tiles when they start or stop blocking projectiles, or change their ground
+		void onTileSightChange(const Position& pos);
+
+		const FlowFieldStats& getFlowFieldStats() const {
+			return flowFieldStats;
+		}
+
+		size_t getFlowFieldCacheSize() const {
+			return flowFields.size();
+		}
+
 		std::map<std::string, Position> waypoints;
 
 		QTreeLeafNode* getQTNode(uint16_t x, uint16_t y) {
+			if (useLeafGrid) {
+				return leafGrid.get(x, y);
+			}
 			return QTreeNode::getLeafStatic<QTreeLeafNode*, QTreeNode*>(&root, x, y);
 		}
 
+		const QTreeLeafNode* getQTNode(uint16_t x, uint16_t y) const {
+			if (useLeafGrid) {
+				return leafGrid.get(x, y);
+			}
+			return QTreeNode::getLeafStatic<const QTreeLeafNode*, const QTreeNode*>(&root, x, y);
+		}
+
+		// selects the leaf lookup backend, only possible before the first tile is set
+		void setLeafGrid(bool enabled);
+
 		Spawns spawns;
 		Towns towns;
 		Houses houses;
 
 	private:
-		SpectatorCache spectatorCache;
-		SpectatorCache playersSpectatorCache;
+		static constexpr size_t MAX_SPECTATOR_CACHE_SIZE = 8192;
+		static constexpr size_t MAX_FLOW_FIELDS = 1024;
+
 		ChunkCache chunksSpectatorCache;
+		SpectatorCacheStats spectatorCacheStats;
+		LeafGrid leafGrid;
+		bool useLeafGrid = false;
+		uint64_t spectatorCacheTick = 0;
+		gtl::node_hash_map<uint64_t, FlowField> flowFields;
+		FlowFieldStats flowFieldStats;
+		uint64_t flowFieldTick = 0;
+		PathGraph pathGraph;
+		uint64_t sightEpoch = 0;
+		TileStats tileStats;
+		bool loadingTiles = false;
 		QTreeNode root;
 
 		std::filesystem::path spawnfile;
@@ -338,7 +681,17 @@ class Map
 		void getSpectatorsInternal(SpectatorVec& spectators, const Position& centerPos,
 		                           int32_t minRangeX, int32_t maxRangeX,
 		                           int32_t minRangeY, int32_t maxRangeY,
-		                           int32_t minRangeZ, int32_t maxRangeZ, bool onlyPlayers) const;
+		                           int32_t minRangeZ, int32_t maxRangeZ, bool onlyPlayers,
+		                           std::vector<std::pair<const QTreeLeafNode*, uint32_t>>* leafVersions = nullptr) const;
+
+		static bool isSpectatorCacheValid(const SpectatorCacheEntry& entry, bool onlyPlayers);
+		static void appendCachedSpectators(const SpectatorCacheEntry& entry, SpectatorVec& spectators);
+		void evictSpectatorCache();
+
+		const FlowField& getFlowField(const Position& targetPos, uint32_t targetId, uint8_t movementClass, uint8_t fieldPenalties);
+		void buildFlowField(FlowField& field, const Position& targetPos, uint8_t movementClass, uint8_t fieldPenalties);
+		static bool isFlowFieldValid(const FlowField& field, const Position& targetPos);
+		void evictFlowFields();
 
 		friend class Game;
 		friend class IOMap;
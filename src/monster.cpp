@@ -116,6 +116,21 @@ bool Monster::canWalkOnFieldType(const CombatType_t combatType) const
 	}
 }
 
+uint8_t Monster::getMovementClass() const
+{
+	uint8_t movementClass = canPushItems() ? MOVEMENTCLASS_PUSHITEMS : MOVEMENTCLASS_NONE;
+	if (ignoreFieldDamage || isImmune(COMBAT_FIREDAMAGE) || canWalkOnFieldType(COMBAT_FIREDAMAGE)) {
+		movementClass |= MOVEMENTCLASS_FIRE;
+	}
+	if (ignoreFieldDamage || isImmune(COMBAT_ENERGYDAMAGE) || canWalkOnFieldType(COMBAT_ENERGYDAMAGE)) {
+		movementClass |= MOVEMENTCLASS_ENERGY;
+	}
+	if (ignoreFieldDamage || isImmune(COMBAT_EARTHDAMAGE) || canWalkOnFieldType(COMBAT_EARTHDAMAGE)) {
+		movementClass |= MOVEMENTCLASS_POISON;
+	}
+	return movementClass;
+}
+
 void Monster::onAttackedCreatureDisappear(bool)
 {
 	attackTicks = 0;
@@ -632,6 +647,7 @@ void Monster::setIdle(const bool idle)
 		return;
 	}
 
+	const bool changed = isIdle != idle;
 	isIdle = idle;
 
 	if (!isIdle) {
@@ -642,12 +658,35 @@ void Monster::setIdle(const bool idle)
 		clearFriendList();
 		Game::removeCreatureCheck(this->getCreature());
 	}
+
+	// summons of a monster hibernate and wake up together with it
+	if (changed) {
+		g_game.onMonsterIdleChanged(*this);
+		for (const auto& summon : summons) {
+			if (const auto& summonMonster = summon->getMonster()) {
+				summonMonster->updateIdleStatus();
+			}
+		}
+	}
+}
+
+void Monster::wakeUpBy(const CreatureConstPtr& creature)
+{
+	// our own move or teleport and creatures we would target end the hibernation,
+	// other monsters walking by do not
+	if (isIdle && (creature.get() == this || isOpponent(creature))) {
+		setIdle(false);
+	}
 }
 
 void Monster::updateIdleStatus()
 {
 	bool idle = false;
-	if (!isSummon() && targetList.empty()) {
+	if (isSummon()) {
+		if (const auto& master = getMaster(); master && master->getMonster()) {
+			idle = master->getMonster()->getIdleStatus() && targetList.empty();
+		}
+	} else if (targetList.empty()) {
 		// check if there are aggressive conditions
 		idle = std::ranges::find_if(conditions, [](const Condition* condition) {
 			return condition->isAggressive();
@@ -657,12 +696,8 @@ void Monster::updateIdleStatus()
 	setIdle(idle);
 }
 
-void Monster::onAddCondition(const ConditionType_t type)
+void Monster::onAddCondition(ConditionType_t)
 {
-	if (type == CONDITION_FIRE || type == CONDITION_ENERGY || type == CONDITION_POISON) {
-		updateMapCache();
-	}
-
 	updateIdleStatus();
 }
 
@@ -670,7 +705,6 @@ void Monster::onEndCondition(const ConditionType_t type)
 {
 	if (type == CONDITION_FIRE || type == CONDITION_ENERGY || type == CONDITION_POISON) {
 		ignoreFieldDamage = false;
-		updateMapCache();
 	}
 
 	updateIdleStatus();
@@ -824,7 +858,7 @@ bool Monster::canUseAttack(const Position& pos, const CreatureConstPtr& target)
 		const uint32_t distance = std::max<uint32_t>(Position::getDistanceX(pos, targetPos), Position::getDistanceY(pos, targetPos));
 		for (const spellBlock_t& spellBlock : mType->info.attackSpells) {
 			if (spellBlock.range != 0 && distance <= spellBlock.range) {
-				return g_game.isSightClear(pos, targetPos, true);
+				return g_game.map.isSightClearCached(pos, targetPos, true);
 			}
 		}
 		return false;
@@ -1178,7 +1212,6 @@ bool Monster::getNextStep(Direction& direction, uint32_t& flags)
 			else {
 				if (ignoreFieldDamage) {
 					ignoreFieldDamage = false;
-					updateMapCache();
 				}
 				// target dancing
 				if (getAttackedCreature() && getAttackedCreature() == getFollowCreature()) {
@@ -1487,7 +1520,7 @@ bool Monster::followTargetFromDistance(const Position& target_position, Directio
 
 	if (int32_t distance = std::max<int32_t>(Position::getDistanceX(monster_position, target_position), Position::getDistanceY(monster_position, target_position));
 		(distance > mType->info.targetDistance or
-		not g_game.isSightClear(monster_position, target_position, true)))
+		not g_game.map.isSightClearCached(monster_position, target_position, true)))
     {
         return false; // let the A* calculate it
     }
@@ -1826,7 +1859,6 @@ void Monster::drainHealth(const CreaturePtr& attacker, const int32_t damage)
 
 	if (damage > 0 && randomStepping) {
 		ignoreFieldDamage = true;
-		updateMapCache();
 	}
 
 	if (isInvisible()) {
@@ -207,6 +207,11 @@ class Monster final : public Creature
 		BlockType_t blockHit(const CreaturePtr& attacker, CombatType_t combatType, int32_t& damage,
 		                     bool checkDefense = false, bool checkArmor = false, bool field = false, bool ignoreResistances = false) override;
 		void setIdle(bool idle);
+		void wakeUpBy(const CreatureConstPtr& creature);
+
+		bool getIdleStatus() const {
+			return isIdle;
+		}
 
 		static uint32_t monsterAutoID;
 
@@ -261,10 +266,6 @@ class Monster final : public Creature
 
 
 		void updateIdleStatus();
-	
-		bool getIdleStatus() const {
-			return isIdle;
-		}
 
 		void onAddCondition(ConditionType_t type) override;
 		void onEndCondition(ConditionType_t type) override;
@@ -313,6 +314,7 @@ class Monster final : public Creature
 		bool useCacheMap() const override {
 			return !randomStepping;
 		}
+		uint8_t getMovementClass() const override;
 
 		friend class LuaScriptInterface;
 };
@@ -119,4 +119,22 @@ void NetworkMessage::addItem(const ItemConstPtr& item)
 void NetworkMessage::addItemId(uint16_t itemId)
 {
 	add<uint16_t>(itemId);
-}
\ No newline at end of file
+}
+
+void PacketBuffer::addString(std::string_view value)
+{
+	if (!canAdd(value.size() + 2)) {
+		return;
+	}
+
+	add<uint16_t>(value.size());
+	memcpy(buffer + length, value.data(), value.size());
+	length += value.size();
+}
+
+void PacketBuffer::addPosition(const Position& pos)
+{
+	add<uint16_t>(pos.x);
+	add<uint16_t>(pos.y);
+	addByte(pos.z);
+}
@@ -164,4 +164,58 @@ class NetworkMessage
 		}
 };
 
+// A packet small enough for the stack. Broadcasts encode it once and every client it
+// goes to only gets the bytes copied into its output buffer.
+class PacketBuffer
+{
+	public:
+		static constexpr size_t MAX_SIZE = 512;
+
+		void addByte(uint8_t value) {
+			if (!canAdd(1)) {
+				return;
+			}
+
+			buffer[length++] = value;
+		}
+
+		template<typename T>
+		void add(T value) {
+			if (!canAdd(sizeof(T))) {
+				return;
+			}
+
+			memcpy(buffer + length, &value, sizeof(T));
+			length += sizeof(T);
+		}
+
+		void addString(std::string_view value);
+		void addPosition(const Position& pos);
+
+		size_t getLength() const {
+			return length;
+		}
+
+		const uint8_t* getBuffer() const {
+			return buffer;
+		}
+
+		bool isOverrun() const {
+			return overrun;
+		}
+
+	private:
+		bool canAdd(size_t size) {
+			if (length + size > MAX_SIZE) {
+				overrun = true;
+				return false;
+			}
+			return true;
+		}
+
+		uint8_t buffer[MAX_SIZE];
+		size_t length = 0;
+		bool overrun = false;
+};
+
 #endif // #ifndef __NETWORK_MESSAGE_H__
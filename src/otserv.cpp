@@ -4,6 +4,7 @@
 #include "otpch.h"
 
 #include "server.h"
+#include "outputmessage.h"
 
 #include "game.h"
 
@@ -73,6 +74,8 @@ int main(int argc, char* argv[])
 
 	ServiceManager serviceManager;
 
+	// packets written by a batch of tasks go out as soon as the batch is done
+	g_dispatcher.setFlushHook([]() { OutputMessagePool::getInstance().sendAll(); });
 	g_dispatcher.start();
 	g_scheduler.start();
 	g_utility_boss.start();
@@ -178,6 +181,8 @@ void mainLoader(int, char*[], ServiceManager* services)
 		return;
 	}
 
+	g_scheduler.setTimerWheel(g_config.getBoolean(ConfigManager::SCHEDULER_TIMER_WHEEL));
+
 #ifdef _WIN32
 	const std::string& defaultPriority = g_config.getString(ConfigManager::DEFAULT_PRIORITY);
 	if (caseInsensitiveEqual(defaultPriority, "high")) {
@@ -6,56 +6,48 @@
 #include "outputmessage.h"
 #include "protocol.h"
 #include "lockfree.h"
-#include "scheduler.h"
-
-extern Scheduler g_scheduler;
 
 namespace {
 
 const uint16_t OUTPUTMESSAGE_FREE_LIST_CAPACITY = 2048;
-const std::chrono::milliseconds OUTPUTMESSAGE_AUTOSEND_DELAY {10};
-
-void sendAll(const std::vector<Protocol_ptr>& bufferedProtocols);
 
-void scheduleSendAll(const std::vector<Protocol_ptr>& bufferedProtocols)
+int64_t flushClock()
 {
-	g_scheduler.addEvent(createSchedulerTask(OUTPUTMESSAGE_AUTOSEND_DELAY.count(), [&]() { sendAll(bufferedProtocols); }));
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
 }
 
-void sendAll(const std::vector<Protocol_ptr>& bufferedProtocols)
-{
-	//dispatcher thread
-	for (auto& protocol : bufferedProtocols) {
-		auto& msg = protocol->getCurrentBuffer();
-		if (msg) {
-			protocol->send(std::move(msg));
-		}
-	}
-
-	if (!bufferedProtocols.empty()) {
-		scheduleSendAll(bufferedProtocols);
-	}
 }
 
-}
-
-void OutputMessagePool::addProtocolToAutosend(Protocol_ptr protocol)
+void OutputMessagePool::addToFlush(Protocol_ptr protocol)
 {
 	//dispatcher thread
-	if (bufferedProtocols.empty()) {
-		scheduleSendAll(bufferedProtocols);
+	if (dirtyProtocols.empty()) {
+		dirtySince = flushClock();
 	}
-	bufferedProtocols.emplace_back(protocol);
+	dirtyProtocols.emplace_back(std::move(protocol));
 }
 
-void OutputMessagePool::removeProtocolFromAutosend(const Protocol_ptr& protocol)
+void OutputMessagePool::sendAll()
 {
 	//dispatcher thread
-	auto it = std::find(bufferedProtocols.begin(), bufferedProtocols.end(), protocol);
-	if (it != bufferedProtocols.end()) {
-		std::swap(*it, bufferedProtocols.back());
-		bufferedProtocols.pop_back();
+	if (dirtyProtocols.empty()) {
+		return;
+	}
+
+	for (auto& protocol : dirtyProtocols) {
+		auto& msg = protocol->getCurrentBuffer();
+		if (msg) {
+			protocol->send(std::move(msg));
+		}
 	}
+
+	const uint64_t delay = flushClock() - dirtySince;
+	++flushStats.flushes;
+	flushStats.buffers += dirtyProtocols.size();
+	flushStats.delay += delay;
+	flushStats.maxDelay = std::max(flushStats.maxDelay, delay);
+
+	dirtyProtocols.clear();
 }
 
 OutputMessage_ptr OutputMessagePool::getOutputMessage()
@@ -76,13 +76,30 @@ class OutputMessagePool
 
 		static OutputMessage_ptr getOutputMessage();
 
-		void addProtocolToAutosend(Protocol_ptr protocol);
-		void removeProtocolFromAutosend(const Protocol_ptr& protocol);
+		struct FlushStats
+		{
+			uint64_t flushes = 0;
+			uint64_t buffers = 0;
+			// microseconds between the oldest buffer of a flush being started and sent
+			uint64_t delay = 0;
+			uint64_t maxDelay = 0;
+		};
+
+		// queues a protocol whose output buffer was just started, it is sent
+		// when the dispatcher finishes its current batch of tasks
+		void addToFlush(Protocol_ptr protocol);
+		void sendAll();
+
+		const FlushStats& getFlushStats() const {
+			return flushStats;
+		}
+
 	private:
 		OutputMessagePool() = default;
-		//NOTE: A vector is used here because this container is mostly read
-		//and relatively rarely modified (only when a client connects/disconnects)
-		std::vector<Protocol_ptr> bufferedProtocols;
+
+		std::vector<Protocol_ptr> dirtyProtocols;
+		int64_t dirtySince = 0;
+		FlushStats flushStats;
 };
 
 #endif
@@ -0,0 +1,186 @@
+// Copyright 2024 Black Tek Server Authors. All rights reserved.
+// Use of this source code is governed by the GPL-2.0 License that can be found in the LICENSE file.
+
+#include "otpch.h"
+
+#include "pathfinding.h"
+
+#include "game.h"
+
+extern Game g_game;
+
+namespace {
+
+int64_t getMicroseconds()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}
+
+PathfindingPool::~PathfindingPool()
+{
+	shutdown();
+}
+
+void PathfindingPool::start(size_t threadCount)
+{
+	if (isRunning()) {
+		return;
+	}
+
+	stopping = false;
+	threads.reserve(std::max<size_t>(1, threadCount));
+	for (size_t i = 0; i < std::max<size_t>(1, threadCount); ++i) {
+		threads.emplace_back(&PathfindingPool::threadMain, this);
+	}
+}
+
+void PathfindingPool::shutdown()
+{
+	{
+		std::lock_guard<std::mutex> lockGuard(mutex);
+		stopping = true;
+	}
+	signal.notify_all();
+
+	for (std::thread& thread : threads) {
+		if (thread.joinable()) {
+			thread.join();
+		}
+	}
+	threads.clear();
+
+	// requests never searched or whose results will not be picked up anymore still
+	// hold tasks and script references, their callbacks release them
+	std::deque<Request> dropped;
+	std::vector<Request> droppedSearched;
+	{
+		std::lock_guard<std::mutex> lockGuard(mutex);
+		dropped.swap(requests);
+		droppedSearched.swap(searched);
+	}
+
+	std::vector<Direction> dirList;
+	for (Request& request : dropped) {
+		request.callback(nullptr, false, dirList);
+	}
+	for (Request& request : droppedSearched) {
+		request.callback(nullptr, false, request.dirList);
+	}
+	latestRequests.clear();
+}
+
+void PathfindingPool::findPath(const CreaturePtr& creature, const Position& targetPos, const FindPathParams& fpp, const PathRequestKind kind, Callback callback)
+{
+	++stats.requests;
+
+	Request request;
+	CreaturePtr self = creature;
+	if (!isRunning() || !g_game.map.captureWalkability(self, targetPos, fpp, request.snapshot)) {
+		++stats.synchronous;
+
+		// a newer request wins even over one still being searched
+		latestRequests.erase(getRequestKey(creature->getID(), kind));
+
+		std::vector<Direction> dirList;
+		const bool found = creature->getPathTo(targetPos, dirList, fpp);
+		callback(creature, found, dirList);
+		return;
+	}
+
+	request.fpp = fpp;
+	request.startPos = creature->getPosition();
+	request.targetPos = targetPos;
+	request.callback = std::move(callback);
+	request.requestTime = getMicroseconds();
+	request.creatureId = creature->getID();
+	request.sequence = ++nextSequence;
+	request.kind = kind;
+	latestRequests[getRequestKey(request.creatureId, kind)] = request.sequence;
+
+	{
+		std::lock_guard<std::mutex> lockGuard(mutex);
+		requests.push_back(std::move(request));
+	}
+	signal.notify_one();
+}
+
+void PathfindingPool::threadMain()
+{
+	std::unique_lock<std::mutex> requestLock(mutex);
+	while (true) {
+		signal.wait(requestLock, [this]() { return stopping || !requests.empty(); });
+		if (stopping) {
+			break;
+		}
+
+		Request request = std::move(requests.front());
+		requests.pop_front();
+		requestLock.unlock();
+
+		request.found = Map::getPathMatching(request.snapshot, request.startPos, request.dirList, FrozenPathingConditionCall(request.targetPos), request.fpp, request.incomplete);
+		request.snapshot = {};
+
+		// the result stays with the pool until the dispatcher takes it, so shutdown can
+		// still release it when the task below never runs
+		requestLock.lock();
+		const bool wasEmpty = searched.empty();
+		searched.push_back(std::move(request));
+		if (wasEmpty) {
+			g_dispatcher.addTask([this]() { completeSearched(); });
+		}
+	}
+}
+
+void PathfindingPool::completeSearched()
+{
+	std::vector<Request> results;
+	{
+		std::lock_guard<std::mutex> lockGuard(mutex);
+		results.swap(searched);
+	}
+
+	for (Request& request : results) {
+		complete(request);
+	}
+}
+
+void PathfindingPool::complete(Request& request)
+{
+	bool found = request.found;
+	std::vector<Direction>& dirList = request.dirList;
+
+	const int64_t latency = getMicroseconds() - request.requestTime;
+	stats.totalLatency += latency;
+	stats.maxLatency = std::max<uint64_t>(stats.maxLatency, latency);
+	++stats.completed;
+
+	auto it = latestRequests.find(getRequestKey(request.creatureId, request.kind));
+	if (it == latestRequests.end() || it->second != request.sequence) {
+		++stats.superseded;
+		request.callback(nullptr, false, dirList);
+		return;
+	}
+	latestRequests.erase(it);
+
+	const auto& creature = g_game.getCreatureByID(request.creatureId);
+	if (!creature || creature->isRemoved()) {
+		++stats.superseded;
+		request.callback(nullptr, false, dirList);
+		return;
+	}
+
+	// the path is only good from where it was searched, a failure at the edge of the
+	// snapshot may have a way around outside of it, and the snapshot left out creatures,
+	// houses and pz locks so a path found on it has to hold up against the map
+	CreaturePtr self = creature;
+	if (creature->getPosition() != request.startPos || (!found && request.incomplete) ||
+			(found && !g_game.map.isPathWalkable(self, request.startPos, dirList))) {
+		++stats.researched;
+		dirList.clear();
+		found = creature->getPathTo(request.targetPos, dirList, request.fpp);
+	}
+
+	request.callback(creature, found, dirList);
+}
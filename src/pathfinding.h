@@ -0,0 +1,99 @@
+// Copyright 2024 Black Tek Server Authors. All rights reserved.
+// Use of this source code is governed by the GPL-2.0 License that can be found in the LICENSE file.
+
+#ifndef FS_PATHFINDING_H
+#define FS_PATHFINDING_H
+
+#include "creature.h"
+#include "map.h"
+
+#include <condition_variable>
+#include <deque>
+
+struct PathfindingStats {
+	uint64_t requests = 0;
+	uint64_t completed = 0;
+	uint64_t superseded = 0;  // the creature asked for another path or went away first
+	uint64_t researched = 0;  // the creature moved, the search left its snapshot or the path is blocked now, searched again on the dispatcher
+	uint64_t synchronous = 0; // searched on the dispatcher right away
+	uint64_t totalLatency = 0; // microseconds from request to result
+	uint64_t maxLatency = 0;
+};
+
+// who asked for a path, a creature has at most one request of each kind pending
+enum class PathRequestKind : uint8_t {
+	WALK,   // a player walking to use, move or trade an item
+	SCRIPT, // creature:getPathToAsync
+};
+
+// Searches paths on worker threads. The dispatcher copies the walkability around
+// the creature, a worker runs A* on that copy and the result is handed back
+// through the dispatcher, where it is checked against what happened meanwhile.
+class PathfindingPool
+{
+	public:
+		// creature is nullptr when the result is no longer wanted, every callback runs once
+		using Callback = std::function<void(const CreaturePtr& creature, bool found, std::vector<Direction>& dirList)>;
+
+		PathfindingPool() = default;
+		~PathfindingPool();
+
+		// non-copyable
+		PathfindingPool(const PathfindingPool&) = delete;
+		PathfindingPool& operator=(const PathfindingPool&) = delete;
+
+		void start(size_t threads);
+		void shutdown();
+
+		bool isRunning() const {
+			return !threads.empty();
+		}
+
+		// dispatcher only, callback always runs on the dispatcher, right away when no workers run
+		void findPath(const CreaturePtr& creature, const Position& targetPos, const FindPathParams& fpp, PathRequestKind kind, Callback callback);
+
+		const PathfindingStats& getStats() const {
+			return stats;
+		}
+
+	private:
+		struct Request {
+			WalkabilitySnapshot snapshot;
+			FindPathParams fpp;
+			Position startPos;
+			Position targetPos;
+			Callback callback;
+			int64_t requestTime = 0;
+			uint32_t creatureId = 0;
+			uint32_t sequence = 0;
+			PathRequestKind kind = PathRequestKind::WALK;
+
+			// filled in by the worker
+			std::vector<Direction> dirList;
+			bool found = false;
+			bool incomplete = false;
+		};
+
+		static uint64_t getRequestKey(uint32_t creatureId, PathRequestKind kind) {
+			return (static_cast<uint64_t>(creatureId) << 8) | static_cast<uint8_t>(kind);
+		}
+
+		void threadMain();
+		void completeSearched();
+		void complete(Request& request);
+
+		std::vector<std::thread> threads;
+
+		std::mutex mutex;
+		std::condition_variable signal;
+		std::deque<Request> requests;
+		std::vector<Request> searched; // waiting for the dispatcher to pick them up
+		bool stopping = false;
+
+		// only touched on the dispatcher
+		gtl::flat_hash_map<uint64_t, uint32_t> latestRequests;
+		uint32_t nextSequence = 0;
+		PathfindingStats stats;
+};
+
+#endif
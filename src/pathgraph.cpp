@@ -0,0 +1,394 @@
+// Copyright 2024 Black Tek Server Authors. All rights reserved.
+// Use of this source code is governed by the GPL-2.0 License that can be found in the LICENSE file.
+
+#include "otpch.h"
+
+#include "pathgraph.h"
+
+#include "map.h"
+#include "workerpool.h"
+
+#include <queue>
+
+namespace {
+
+bool isWalkable(const TileConstPtr& tile)
+{
+	return tile && tile->getGround() && !tile->hasFlag(TILESTATE_BLOCKSOLID | TILESTATE_FLOORCHANGE | TILESTATE_TELEPORT);
+}
+
+size_t getTileIndex(const int32_t x, const int32_t y)
+{
+	return y * PathGraph::CLUSTER_SIZE + x;
+}
+
+}
+
+void PathGraph::build(Map& map, const uint32_t width, const uint32_t height, const bool parallel)
+{
+	enabled = true;
+
+	const auto buildStart = OTSYS_TIME();
+
+	std::vector<uint32_t> keys;
+	for (int32_t z = 0; z < MAP_MAX_LAYERS; ++z) {
+		for (uint32_t y = 0; y < height; y += CLUSTER_SIZE) {
+			for (uint32_t x = 0; x < width; x += CLUSTER_SIZE) {
+				bool hasTiles = false;
+				for (uint32_t leafY = y; leafY < y + CLUSTER_SIZE && !hasTiles; leafY += FLOOR_SIZE) {
+					for (uint32_t leafX = x; leafX < x + CLUSTER_SIZE && !hasTiles; leafX += FLOOR_SIZE) {
+						const QTreeLeafNode* leaf = map.getQTNode(leafX, leafY);
+						hasTiles = leaf && leaf->getFloor(z);
+					}
+				}
+
+				if (hasTiles) {
+					keys.push_back(getClusterKey(x, y, z));
+				}
+			}
+		}
+	}
+
+	// clusters only read the map, each is built on its own
+	std::vector<Cluster> built(keys.size());
+	{
+		WorkerPool builders;
+		if (parallel) {
+			builders.start(0);
+		}
+
+		builders.parallelFor(keys.size(), [&](size_t i) {
+			buildCluster(map, keys[i], built[i]);
+		});
+	}
+
+	clusters.reserve(keys.size());
+	for (size_t i = 0; i < keys.size(); ++i) {
+		clusters[keys[i]] = std::move(built[i]);
+	}
+
+	std::cout << "> Path graph: " << clusters.size() << " clusters built in " << (OTSYS_TIME() - buildStart) / 1000. << " seconds." << std::endl;
+}
+
+void PathGraph::invalidate(const Position& pos)
+{
+	if (!enabled) {
+		return;
+	}
+
+	const auto markDirty = [this](const uint16_t x, const uint16_t y, const uint8_t z) {
+		if (auto it = clusters.find(getClusterKey(x, y, z)); it != clusters.end()) {
+			it->second.dirty = true;
+		}
+	};
+
+	markDirty(pos.x, pos.y, pos.z);
+
+	// tiles on a border decide the entrances of the cluster on the other side too
+	if ((pos.x & CLUSTER_MASK) == 0 && pos.x > 0) {
+		markDirty(pos.x - 1, pos.y, pos.z);
+	} else if ((pos.x & CLUSTER_MASK) == CLUSTER_MASK && pos.x < std::numeric_limits<uint16_t>::max()) {
+		markDirty(pos.x + 1, pos.y, pos.z);
+	}
+
+	if ((pos.y & CLUSTER_MASK) == 0 && pos.y > 0) {
+		markDirty(pos.x, pos.y - 1, pos.z);
+	} else if ((pos.y & CLUSTER_MASK) == CLUSTER_MASK && pos.y < std::numeric_limits<uint16_t>::max()) {
+		markDirty(pos.x, pos.y + 1, pos.z);
+	}
+}
+
+void PathGraph::readTiles(Map& map, const uint32_t key, ClusterTiles& tiles)
+{
+	const Position origin = getClusterOrigin(key);
+	for (int32_t y = -1; y <= CLUSTER_SIZE; ++y) {
+		for (int32_t x = -1; x <= CLUSTER_SIZE; ++x) {
+			const int32_t tileX = origin.x + x;
+			const int32_t tileY = origin.y + y;
+			if (tileX < 0 || tileY < 0 || tileX > std::numeric_limits<uint16_t>::max() || tileY > std::numeric_limits<uint16_t>::max()) {
+				tiles[y + 1][x + 1] = false;
+				continue;
+			}
+			tiles[y + 1][x + 1] = isWalkable(map.getTile(tileX, tileY, origin.z));
+		}
+	}
+}
+
+void PathGraph::walkCluster(const ClusterTiles& tiles, const int32_t x, const int32_t y, ClusterCosts& costs)
+{
+	static constexpr int32_t neighbors[8][2] = {
+		{-1, 0}, {0, 1}, {1, 0}, {0, -1}, {-1, -1}, {1, -1}, {1, 1}, {-1, 1}
+	};
+
+	costs.fill(UNREACHABLE);
+	costs[getTileIndex(x, y)] = 0;
+
+	// the first tile is taken as it is, a path may start on or lead to a blocked one
+	std::priority_queue<std::pair<uint16_t, uint16_t>, std::vector<std::pair<uint16_t, uint16_t>>, std::greater<>> open;
+	open.emplace(0, getTileIndex(x, y));
+	while (!open.empty()) {
+		const auto [cost, index] = open.top();
+		open.pop();
+		if (cost != costs[index]) {
+			continue;
+		}
+
+		const int32_t tileX = index % CLUSTER_SIZE;
+		const int32_t tileY = index / CLUSTER_SIZE;
+		for (int32_t i = 0; i < 8; ++i) {
+			const int32_t neighborX = tileX + neighbors[i][0];
+			const int32_t neighborY = tileY + neighbors[i][1];
+			if (neighborX < 0 || neighborY < 0 || neighborX >= CLUSTER_SIZE || neighborY >= CLUSTER_SIZE || !tiles[neighborY + 1][neighborX + 1]) {
+				continue;
+			}
+
+			const uint16_t neighborCost = cost + (i < 4 ? MAP_NORMALWALKCOST : MAP_DIAGONALWALKCOST);
+			uint16_t& known = costs[getTileIndex(neighborX, neighborY)];
+			if (neighborCost < known) {
+				known = neighborCost;
+				open.emplace(neighborCost, getTileIndex(neighborX, neighborY));
+			}
+		}
+	}
+}
+
+void PathGraph::buildCluster(Map& map, const uint32_t key, Cluster& cluster)
+{
+	ClusterTiles tiles;
+	readTiles(map, key, tiles);
+
+	cluster.nodes.clear();
+	cluster.edges.clear();
+	cluster.dirty = false;
+
+	const auto addNode = [&cluster](const uint8_t x, const uint8_t y) {
+		for (const Node& node : cluster.nodes) {
+			if (node.x == x && node.y == y) {
+				return;
+			}
+		}
+		cluster.nodes.push_back({x, y, 0, 0});
+	};
+
+	// both clusters of a border see the same openings, so their entrances line up
+	static constexpr int32_t sides[4][4] = {
+		// first tile, step along the side, offset to the tile across
+		{0, 0, 1, 0}, {0, CLUSTER_MASK, 1, 0}, {0, 0, 0, 1}, {CLUSTER_MASK, 0, 0, 1}
+	};
+	static constexpr int32_t across[4][2] = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}};
+
+	for (int32_t side = 0; side < 4; ++side) {
+		int32_t openingStart = -1;
+		for (int32_t i = 0; i <= CLUSTER_SIZE; ++i) {
+			const int32_t x = sides[side][0] + sides[side][2] * i;
+			const int32_t y = sides[side][1] + sides[side][3] * i;
+			const bool open = i < CLUSTER_SIZE && tiles[y + 1][x + 1] && tiles[y + across[side][1] + 1][x + across[side][0] + 1];
+			if (open) {
+				if (openingStart == -1) {
+					openingStart = i;
+				}
+				continue;
+			}
+
+			if (openingStart == -1) {
+				continue;
+			}
+
+			const int32_t openingEnd = i - 1;
+			if (openingEnd - openingStart + 1 <= MAX_ENTRANCE_WIDTH) {
+				const int32_t middle = (openingStart + openingEnd) / 2;
+				addNode(sides[side][0] + sides[side][2] * middle, sides[side][1] + sides[side][3] * middle);
+			} else {
+				addNode(sides[side][0] + sides[side][2] * openingStart, sides[side][1] + sides[side][3] * openingStart);
+				addNode(sides[side][0] + sides[side][2] * openingEnd, sides[side][1] + sides[side][3] * openingEnd);
+			}
+			openingStart = -1;
+		}
+	}
+
+	ClusterCosts costs;
+	for (Node& node : cluster.nodes) {
+		walkCluster(tiles, node.x, node.y, costs);
+
+		node.firstEdge = cluster.edges.size();
+		for (size_t i = 0; i < cluster.nodes.size(); ++i) {
+			const Node& other = cluster.nodes[i];
+			if (&other == &node) {
+				continue;
+			}
+
+			if (const uint16_t cost = costs[getTileIndex(other.x, other.y)]; cost != UNREACHABLE) {
+				cluster.edges.push_back({cost, static_cast<uint8_t>(i)});
+			}
+		}
+		node.edgeCount = cluster.edges.size() - node.firstEdge;
+	}
+}
+
+const PathGraph::Cluster& PathGraph::getCluster(Map& map, const uint32_t key)
+{
+	auto it = clusters.find(key);
+	if (it == clusters.end()) {
+		it = clusters.emplace(key, Cluster()).first;
+		buildCluster(map, key, it->second);
+	} else if (it->second.dirty) {
+		buildCluster(map, key, it->second);
+		++stats.rebuilds;
+	}
+	return it->second;
+}
+
+bool PathGraph::findWaypoints(Map& map, const Position& startPos, const Position& targetPos, std::vector<Position>& waypoints)
+{
+	if (startPos.z != targetPos.z) {
+		return false;
+	}
+
+	++stats.searches;
+
+	const uint32_t startKey = getClusterKey(startPos.x, startPos.y, startPos.z);
+	const uint32_t goalKey = getClusterKey(targetPos.x, targetPos.y, targetPos.z);
+
+	// the start and the target join the graph through what they can reach of their own clusters
+	ClusterTiles tiles;
+	ClusterCosts startCosts, goalCosts;
+	readTiles(map, startKey, tiles);
+	walkCluster(tiles, startPos.x & CLUSTER_MASK, startPos.y & CLUSTER_MASK, startCosts);
+	if (goalKey != startKey) {
+		readTiles(map, goalKey, tiles);
+	}
+	walkCluster(tiles, targetPos.x & CLUSTER_MASK, targetPos.y & CLUSTER_MASK, goalCosts);
+
+	if (startKey == goalKey) {
+		for (size_t i = 0; i < startCosts.size(); ++i) {
+			if (startCosts[i] != UNREACHABLE && goalCosts[i] != UNREACHABLE) {
+				waypoints.push_back(targetPos);
+				++stats.found;
+				return true;
+			}
+		}
+	}
+
+	static constexpr uint64_t START_NODE = std::numeric_limits<uint64_t>::max();
+	static constexpr uint64_t GOAL_NODE = START_NODE - 1;
+
+	struct Visit {
+		uint64_t parent;
+		uint32_t cost;
+		bool closed;
+	};
+
+	gtl::flat_hash_map<uint64_t, Visit> visits;
+	std::priority_queue<std::pair<uint32_t, uint64_t>, std::vector<std::pair<uint32_t, uint64_t>>, std::greater<>> open;
+
+	const auto getNodeId = [](const uint32_t key, const size_t index) {
+		return (static_cast<uint64_t>(key) << 8) | index;
+	};
+
+	const auto getNodePosition = [this, &map](const uint64_t id) {
+		const uint32_t key = id >> 8;
+		const Node& node = getCluster(map, key).nodes[id & 0xFF];
+		const Position origin = getClusterOrigin(key);
+		return Position(origin.x + node.x, origin.y + node.y, origin.z);
+	};
+
+	const auto visit = [&](const uint64_t id, const uint32_t cost, const uint64_t parent, const Position& pos) {
+		auto [it, inserted] = visits.try_emplace(id, Visit{parent, cost, false});
+		if (!inserted) {
+			if (it->second.closed || it->second.cost <= cost) {
+				return;
+			}
+			it->second.parent = parent;
+			it->second.cost = cost;
+		}
+
+		// no step is cheaper than a straight one, the estimate never overshoots
+		const uint32_t estimate = (Position::getDistanceX(pos, targetPos) + Position::getDistanceY(pos, targetPos)) * MAP_NORMALWALKCOST;
+		open.emplace(cost + estimate, id);
+	};
+
+	{
+		const Cluster& startCluster = getCluster(map, startKey);
+		const Position origin = getClusterOrigin(startKey);
+		for (size_t i = 0; i < startCluster.nodes.size(); ++i) {
+			const Node& node = startCluster.nodes[i];
+			if (const uint16_t cost = startCosts[getTileIndex(node.x, node.y)]; cost != UNREACHABLE) {
+				visit(getNodeId(startKey, i), cost, START_NODE, Position(origin.x + node.x, origin.y + node.y, origin.z));
+			}
+		}
+	}
+
+	static constexpr int32_t neighbors[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+
+	size_t expanded = 0;
+	while (!open.empty()) {
+		const uint64_t id = open.top().second;
+		open.pop();
+
+		if (id == GOAL_NODE) {
+			std::vector<Position> reversed;
+			for (uint64_t node = visits[GOAL_NODE].parent; node != START_NODE; node = visits[node].parent) {
+				reversed.push_back(getNodePosition(node));
+			}
+
+			waypoints.insert(waypoints.end(), reversed.rbegin(), reversed.rend());
+			waypoints.push_back(targetPos);
+			++stats.found;
+			return true;
+		}
+
+		auto it = visits.find(id);
+		if (it->second.closed) {
+			continue;
+		}
+		it->second.closed = true;
+
+		if (++expanded > MAX_EXPANDED_NODES) {
+			break;
+		}
+
+		// visit() may move the entries around
+		const uint32_t cost = it->second.cost;
+		const uint32_t key = id >> 8;
+		const Cluster& cluster = getCluster(map, key);
+		const Node& node = cluster.nodes[id & 0xFF];
+		const Position origin = getClusterOrigin(key);
+		const Position pos(origin.x + node.x, origin.y + node.y, origin.z);
+
+		if (key == goalKey) {
+			if (const uint16_t goalCost = goalCosts[getTileIndex(node.x, node.y)]; goalCost != UNREACHABLE) {
+				visit(GOAL_NODE, cost + goalCost, id, targetPos);
+			}
+		}
+
+		for (uint16_t i = node.firstEdge, end = node.firstEdge + node.edgeCount; i < end; ++i) {
+			const Edge& edge = cluster.edges[i];
+			const Node& other = cluster.nodes[edge.to];
+			visit(getNodeId(key, edge.to), cost + edge.cost, id, Position(origin.x + other.x, origin.y + other.y, origin.z));
+		}
+
+		// entrances pair up with the tile right across the border
+		for (const auto& offset : neighbors) {
+			const int32_t acrossX = pos.x + offset[0];
+			const int32_t acrossY = pos.y + offset[1];
+			if (acrossX < 0 || acrossY < 0 || acrossX > std::numeric_limits<uint16_t>::max() || acrossY > std::numeric_limits<uint16_t>::max()) {
+				continue;
+			}
+
+			const uint32_t acrossKey = getClusterKey(acrossX, acrossY, pos.z);
+			if (acrossKey == key) {
+				continue;
+			}
+
+			const Cluster& acrossCluster = getCluster(map, acrossKey);
+			for (size_t i = 0; i < acrossCluster.nodes.size(); ++i) {
+				const Node& other = acrossCluster.nodes[i];
+				if (other.x == (acrossX & CLUSTER_MASK) && other.y == (acrossY & CLUSTER_MASK)) {
+					visit(getNodeId(acrossKey, i), cost + MAP_NORMALWALKCOST, id, Position(acrossX, acrossY, pos.z));
+					break;
+				}
+			}
+		}
+	}
+	return false;
+}
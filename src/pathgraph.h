@@ -0,0 +1,107 @@
+// Copyright 2024 Black Tek Server Authors. All rights reserved.
+// Use of this source code is governed by the GPL-2.0 License that can be found in the LICENSE file.
+
+#ifndef FS_PATHGRAPH_H
+#define FS_PATHGRAPH_H
+
+#include "position.h"
+
+#include <gtl/phmap.hpp>
+
+class Map;
+
+struct PathGraphStats {
+	uint64_t searches = 0;
+	uint64_t found = 0;
+	uint64_t refineFailures = 0; // the entrances were found but the creature could not walk between them
+	uint64_t rebuilds = 0;
+};
+
+// Abstract graph over the map for paths longer than A* can search (HPA*). Every floor is
+// cut into clusters of CLUSTER_SIZE x CLUSTER_SIZE tiles, where walkable tiles meet across
+// a cluster border both sides get an entrance, and the entrances of a cluster are linked
+// by the cost of walking between them inside it. A long path is searched over entrances
+// and walked out with A* between consecutive ones.
+// Walkability here is what no creature can get past: missing ground, solid items, floor
+// changes and teleports. Creatures and fields are left to the A* that walks the path out.
+class PathGraph
+{
+	public:
+		static constexpr int32_t CLUSTER_BITS = 4;
+		static constexpr int32_t CLUSTER_SIZE = 1 << CLUSTER_BITS;
+		static constexpr int32_t CLUSTER_MASK = CLUSTER_SIZE - 1;
+
+		// builds the clusters of every area of the map that has tiles, further clusters are built when first searched
+		void build(Map& map, uint32_t width, uint32_t height, bool parallel);
+
+		bool isEnabled() const {
+			return enabled;
+		}
+
+		// the walkability of pos changed, the clusters it belongs to are rebuilt when next searched
+		void invalidate(const Position& pos);
+
+		/**
+		  * Searches the entrances to walk through from startPos to targetPos, both on one floor
+		  * \param waypoints the entrances in walking order, followed by targetPos
+		  */
+		bool findWaypoints(Map& map, const Position& startPos, const Position& targetPos, std::vector<Position>& waypoints);
+
+		void onRefineFailure() {
+			++stats.refineFailures;
+		}
+
+		const PathGraphStats& getStats() const {
+			return stats;
+		}
+
+		size_t getClusterCount() const {
+			return clusters.size();
+		}
+
+	private:
+		// openings wider than this get an entrance at both ends instead of one in the middle
+		static constexpr int32_t MAX_ENTRANCE_WIDTH = 6;
+		static constexpr size_t MAX_EXPANDED_NODES = 8192;
+		static constexpr uint16_t UNREACHABLE = std::numeric_limits<uint16_t>::max();
+
+		struct Edge {
+			uint16_t cost;
+			uint8_t to;
+		};
+
+		struct Node {
+			uint8_t x, y; // inside the cluster
+			uint16_t firstEdge;
+			uint16_t edgeCount;
+		};
+
+		struct Cluster {
+			std::vector<Node> nodes;
+			std::vector<Edge> edges;
+			bool dirty = false;
+		};
+
+		// walkability of a cluster and the ring of tiles around it
+		using ClusterTiles = std::array<std::array<bool, CLUSTER_SIZE + 2>, CLUSTER_SIZE + 2>;
+		using ClusterCosts = std::array<uint16_t, CLUSTER_SIZE * CLUSTER_SIZE>;
+
+		static uint32_t getClusterKey(uint16_t x, uint16_t y, uint8_t z) {
+			return (static_cast<uint32_t>(z) << 24) | ((static_cast<uint32_t>(y) >> CLUSTER_BITS) << 12) | (static_cast<uint32_t>(x) >> CLUSTER_BITS);
+		}
+		static Position getClusterOrigin(uint32_t key) {
+			return Position((key & 0xFFF) << CLUSTER_BITS, ((key >> 12) & 0xFFF) << CLUSTER_BITS, key >> 24);
+		}
+
+		static void readTiles(Map& map, uint32_t key, ClusterTiles& tiles);
+		static void walkCluster(const ClusterTiles& tiles, int32_t x, int32_t y, ClusterCosts& costs);
+		static void buildCluster(Map& map, uint32_t key, Cluster& cluster);
+
+		const Cluster& getCluster(Map& map, uint32_t key);
+
+		gtl::node_hash_map<uint32_t, Cluster> clusters;
+		PathGraphStats stats;
+		bool enabled = false;
+};
+
+#endif
@@ -1767,10 +1767,8 @@ void Player::sendRemoveContainerItem(const ContainerConstPtr& container, const u
 }
 
 void Player::onUpdateTileItem(const TilePtr& tile, const Position& pos, const ItemPtr& oldItem,
-                              const ItemType& oldType, const ItemPtr& newItem, const ItemType& newType)
+                              const ItemType& oldType, const ItemPtr& newItem, const ItemType&)
 {
-	Creature::onUpdateTileItem(tile, pos, oldItem, oldType, newItem, newType);
-
 	if (oldItem != newItem) {
 		onRemoveTileItem(tile, pos, oldType, oldItem);
 	}
@@ -1782,11 +1780,9 @@ void Player::onUpdateTileItem(const TilePtr& tile, const Position& pos, const It
 	}
 }
 
-void Player::onRemoveTileItem(const TilePtr& tile, const Position& pos, const ItemType& iType,
+void Player::onRemoveTileItem(const TilePtr&, const Position&, const ItemType&,
                               const ItemPtr& item)
 {
-	Creature::onRemoveTileItem(tile, pos, iType, item);
-
 	if (tradeState != TRADE_TRANSFER) {
 		checkTradeState(item);
 
@@ -3968,7 +3964,7 @@ void Player::doAttacking(uint32_t)
 			result = Weapon::useFist(this->getPlayer(), getAttackedCreature());
 		}
 
-		SchedulerTask* task = createSchedulerTask(std::max<uint32_t>(SCHEDULER_MINTICKS, delay), [id = getID()]() { g_game.checkCreatureAttack(id); });
+		SchedulerTask* task = createSchedulerTask("Game::checkCreatureAttack", std::max<uint32_t>(SCHEDULER_MINTICKS, delay), [id = getID()]() { g_game.checkCreatureAttack(id); });
 		if (!classicSpeed) {
 			setNextActionTask(task, false);
 		} else {
@@ -1147,6 +1147,12 @@ class Player final : public Creature, public Cylinder
 				client->sendMagicEffect(pos, type);
 			}
 		}
+		// an effect already encoded by ProtocolGame::AddMagicEffect
+		void sendMagicEffect(const PacketBuffer& packet, const Position& pos) const {
+			if (client) {
+				client->sendMagicEffect(packet, pos);
+			}
+		}
 	
 		void sendPing();
 	
@@ -1362,6 +1368,11 @@ class Player final : public Creature, public Cylinder
 				client->writeToOutputBuffer(message);
 			}
 		}
+		void sendPacket(const PacketBuffer& packet) const {
+			if (client) {
+				client->writePacket(packet);
+			}
+		}
 
 		void receivePing() {
 			lastPong = OTSYS_TIME();
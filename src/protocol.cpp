@@ -70,6 +70,7 @@ OutputMessage_ptr Protocol::getOutputBuffer(int32_t size)
 	//dispatcher thread
 	if (!outputBuffer) {
 		outputBuffer = OutputMessagePool::getOutputMessage();
+		OutputMessagePool::getInstance().addToFlush(shared_from_this());
 	} else if ((outputBuffer->getLength() + size) > NetworkMessage::MAX_PROTOCOL_BODY_LENGTH) {
 		send(std::move(outputBuffer));
 		outputBuffer = OutputMessagePool::getOutputMessage();
@@ -148,13 +148,22 @@ void ProtocolGame::release()
 		player = nullptr;
 	}
 
-	OutputMessagePool::getInstance().removeProtocolFromAutosend(shared_from_this());
 	Protocol::release();
 }
 
 void ProtocolGame::login(uint32_t characterId, uint32_t accountId, OperatingSystem_t operatingSystem)
 {
 	//dispatcher thread
+	// written here rather than in onRecvFirstMessage, the output buffer may only be touched by the dispatcher
+	if (operatingSystem >= CLIENTOS_OTCLIENT_LINUX)
+	{
+		NetworkMessage opcodeMessage;
+		opcodeMessage.add(ServerCode::ExtendedOpcode);
+		opcodeMessage.add(CommonCode::Zero); // uint8_t -- 1 byte width
+		opcodeMessage.add<SpecialCode>(SpecialCode::Zero); // uint16_t -- 2 byte width
+		writeToOutputBuffer(opcodeMessage);
+	}
+
 	const auto& foundPlayer = g_game.getPlayerByGUID(characterId);
 	const auto managerEnabled = g_config.getBoolean(ConfigManager::ENABLE_ACCOUNT_MANAGER);
 	const auto isAccountManager = characterId == AccountManager::ID and managerEnabled;
@@ -292,7 +301,7 @@ void ProtocolGame::login(uint32_t characterId, uint32_t accountId, OperatingSyst
 			foundPlayer->disconnect();
 			foundPlayer->isConnecting = true;
 
-			eventConnect = g_scheduler.addEvent(createSchedulerTask(1000, [=, thisPtr = getThis(), playerID = foundPlayer->getID()]()
+			eventConnect = g_scheduler.addEvent(createSchedulerTask("ProtocolGame::connect", 1000, [=, thisPtr = getThis(), playerID = foundPlayer->getID()]()
 			{
 				thisPtr->connect(playerID, operatingSystem);
 			}));
@@ -302,7 +311,6 @@ void ProtocolGame::login(uint32_t characterId, uint32_t accountId, OperatingSyst
 			connect(foundPlayer->getID(), operatingSystem);
 		}
 	}
-	OutputMessagePool::getInstance().addProtocolToAutosend(shared_from_this());
 }
 
 void ProtocolGame::connect(uint32_t playerId, OperatingSystem_t operatingSystem)
@@ -410,15 +418,6 @@ void ProtocolGame::onRecvFirstMessage(NetworkMessage& msg)
 	enableXTEAEncryption();
 	setXTEAKey(std::move(key));
 
-	if (operatingSystem >= CLIENTOS_OTCLIENT_LINUX)
-	{
-		NetworkMessage opcodeMessage;
-		opcodeMessage.add(ServerCode::ExtendedOpcode);
-		opcodeMessage.add(CommonCode::Zero); // uint8_t -- 1 byte width
-		opcodeMessage.add<SpecialCode>(SpecialCode::Zero); // uint16_t -- 2 byte width
-		writeToOutputBuffer(opcodeMessage);
-	}
-
 	msg.skipBytes(1); // gamemaster flag
 
 	// acc name or email, password, token, timestamp divided by 30
@@ -558,6 +557,17 @@ void ProtocolGame::writeToOutputBuffer(const NetworkMessage& msg)
 	out->append(msg);
 }
 
+NetworkMessage& ProtocolGame::startPacket(const int32_t maxSize)
+{
+	// the buffer stays referenced by the protocol until it is sent, which only happens on this thread
+	return *getOutputBuffer(maxSize);
+}
+
+void ProtocolGame::writePacket(const PacketBuffer& packet)
+{
+	startPacket(packet.getLength()).addBytes(reinterpret_cast<const char*>(packet.getBuffer()), packet.getLength());
+}
+
 void ProtocolGame::parsePacket(NetworkMessage& msg)
 {
 	if (not acceptPackets or g_game.getGameState() == GAME_STATE_SHUTDOWN or msg.getLength() == 0)
@@ -599,12 +609,12 @@ void ProtocolGame::parsePacket(NetworkMessage& msg)
 	{
 		switch (recvbyte)
 		{
-			case ClientCode::Logout: addGameTask([thisPtr = getThis()]() { thisPtr->logout(true, false); });	break;
-			case ClientCode::PingBack: addGameTask([player_id]() { g_game.playerReceivePingBack(player_id); }); break;
-			case ClientCode::Ping: addGameTask([player_id]() { g_game.playerReceivePing(player_id); }); break;
+			case ClientCode::Logout: addGameTask("ProtocolGame::logout", [thisPtr = getThis()]() { thisPtr->logout(true, false); });	break;
+			case ClientCode::PingBack: addGameTask("Game::playerReceivePingBack", [player_id]() { g_game.playerReceivePingBack(player_id); }); break;
+			case ClientCode::Ping: addGameTask("Game::playerReceivePing", [player_id]() { g_game.playerReceivePing(player_id); }); break;
 			case ClientCode::TextWindow: parseTextWindow(msg); break;
 			case ClientCode::ModalWindowAnswer: parseModalWindowAnswer(msg); break;
-			default: addGameTask([player_id]() { g_game.doAccountManagerReset(player_id); });	break;
+			default: addGameTask("Game::doAccountManagerReset", [player_id]() { g_game.doAccountManagerReset(player_id); });	break;
 		}
 
 		if (msg.isOverrun())
@@ -617,34 +627,34 @@ void ProtocolGame::parsePacket(NetworkMessage& msg)
 
 	switch (recvbyte)
 	{
-		case ClientCode::Logout: addGameTask([thisPtr = getThis()]() { thisPtr->logout(true, false); }); break;
-		case ClientCode::PingBack: addGameTask([player_id]() { g_game.playerReceivePingBack(player_id); }); break;
-		case ClientCode::Ping: addGameTask([player_id]() { g_game.playerReceivePing(player_id); }); break;
+		case ClientCode::Logout: addGameTask("ProtocolGame::logout", [thisPtr = getThis()]() { thisPtr->logout(true, false); }); break;
+		case ClientCode::PingBack: addGameTask("Game::playerReceivePingBack", [player_id]() { g_game.playerReceivePingBack(player_id); }); break;
+		case ClientCode::Ping: addGameTask("Game::playerReceivePing", [player_id]() { g_game.playerReceivePing(player_id); }); break;
 		case ClientCode::ExtendedOpcode: parseExtendedOpcode(msg); break; //otclient extended opcode
 		case ClientCode::AutoWalk: parseAutoWalk(msg); break;
-		case ClientCode::MoveNorth: addGameTask([player_id]() { g_game.playerMove(player_id, DIRECTION_NORTH); }); break;
-		case ClientCode::MoveEast: addGameTask([player_id]() { g_game.playerMove(player_id, DIRECTION_EAST); }); break;
-		case ClientCode::MoveSouth: addGameTask([player_id]() { g_game.playerMove(player_id, DIRECTION_SOUTH); }); break;
-		case ClientCode::MoveWest: addGameTask([player_id]() { g_game.playerMove(player_id, DIRECTION_WEST); }); break;
-		case ClientCode::StopAutoWalk: addGameTask([player_id]() { g_game.playerStopAutoWalk(player_id); }); break;
-		case ClientCode::MoveNorthEast: addGameTask([player_id]() { g_game.playerMove(player_id, DIRECTION_NORTHEAST); }); break;
-		case ClientCode::MoveSouthEast: addGameTask([player_id]() { g_game.playerMove(player_id, DIRECTION_SOUTHEAST); }); break;
-		case ClientCode::MoveSouthWest: addGameTask([player_id]() { g_game.playerMove(player_id, DIRECTION_SOUTHWEST); }); break;
-		case ClientCode::MoveNorthWest: addGameTask([player_id]() { g_game.playerMove(player_id, DIRECTION_NORTHWEST); }); break;
-		case ClientCode::TurnNorth: addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, [player_id]() { g_game.playerTurn(player_id, DIRECTION_NORTH); }); break;
-		case ClientCode::TurnEast: addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, [player_id]() { g_game.playerTurn(player_id, DIRECTION_EAST); }); break;
-		case ClientCode::TurnSouth: addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, [player_id]() { g_game.playerTurn(player_id, DIRECTION_SOUTH); }); break;
-		case ClientCode::TurnWest: addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, [player_id]() { g_game.playerTurn(player_id, DIRECTION_WEST); }); break;
+		case ClientCode::MoveNorth: addGameTask("Game::playerMove", [player_id]() { g_game.playerMove(player_id, DIRECTION_NORTH); }); break;
+		case ClientCode::MoveEast: addGameTask("Game::playerMove", [player_id]() { g_game.playerMove(player_id, DIRECTION_EAST); }); break;
+		case ClientCode::MoveSouth: addGameTask("Game::playerMove", [player_id]() { g_game.playerMove(player_id, DIRECTION_SOUTH); }); break;
+		case ClientCode::MoveWest: addGameTask("Game::playerMove", [player_id]() { g_game.playerMove(player_id, DIRECTION_WEST); }); break;
+		case ClientCode::StopAutoWalk: addGameTask("Game::playerStopAutoWalk", [player_id]() { g_game.playerStopAutoWalk(player_id); }); break;
+		case ClientCode::MoveNorthEast: addGameTask("Game::playerMove", [player_id]() { g_game.playerMove(player_id, DIRECTION_NORTHEAST); }); break;
+		case ClientCode::MoveSouthEast: addGameTask("Game::playerMove", [player_id]() { g_game.playerMove(player_id, DIRECTION_SOUTHEAST); }); break;
+		case ClientCode::MoveSouthWest: addGameTask("Game::playerMove", [player_id]() { g_game.playerMove(player_id, DIRECTION_SOUTHWEST); }); break;
+		case ClientCode::MoveNorthWest: addGameTask("Game::playerMove", [player_id]() { g_game.playerMove(player_id, DIRECTION_NORTHWEST); }); break;
+		case ClientCode::TurnNorth: addGameTaskTimed("Game::playerTurn", DISPATCHER_TASK_EXPIRATION, [player_id]() { g_game.playerTurn(player_id, DIRECTION_NORTH); }); break;
+		case ClientCode::TurnEast: addGameTaskTimed("Game::playerTurn", DISPATCHER_TASK_EXPIRATION, [player_id]() { g_game.playerTurn(player_id, DIRECTION_EAST); }); break;
+		case ClientCode::TurnSouth: addGameTaskTimed("Game::playerTurn", DISPATCHER_TASK_EXPIRATION, [player_id]() { g_game.playerTurn(player_id, DIRECTION_SOUTH); }); break;
+		case ClientCode::TurnWest: addGameTaskTimed("Game::playerTurn", DISPATCHER_TASK_EXPIRATION, [player_id]() { g_game.playerTurn(player_id, DIRECTION_WEST); }); break;
 		case ClientCode::EquipObject: parseEquipObject(msg); break;
 		case ClientCode::Throw: parseThrow(msg); break;
 		case ClientCode::LookInShop: parseLookInShop(msg); break;
 		case ClientCode::Purchase: parsePlayerPurchase(msg); break;
 		case ClientCode::Sale: parsePlayerSale(msg); break;
-		case ClientCode::CloseShop: addGameTask([player_id]() { g_game.playerCloseShop(player_id); }); break;
+		case ClientCode::CloseShop: addGameTask("Game::playerCloseShop", [player_id]() { g_game.playerCloseShop(player_id); }); break;
 		case ClientCode::RequestTrade: parseRequestTrade(msg); break;
 		case ClientCode::LookInTrade: parseLookInTrade(msg); break;
-		case ClientCode::AcceptTrade: addGameTask([player_id]() { g_game.playerAcceptTrade(player_id); }); break;
-		case ClientCode::CloseTrade: addGameTask([player_id]() { g_game.playerCloseTrade(player_id); }); break;
+		case ClientCode::AcceptTrade: addGameTask("Game::playerAcceptTrade", [player_id]() { g_game.playerAcceptTrade(player_id); }); break;
+		case ClientCode::CloseTrade: addGameTask("Game::playerCloseTrade", [player_id]() { g_game.playerCloseTrade(player_id); }); break;
 		case ClientCode::UseItem: parseUseItem(msg); break;
 		case ClientCode::UseItemEx: parseUseItemEx(msg); break;
 		case ClientCode::UseWithCreature: parseUseWithCreature(msg); break;
@@ -658,11 +668,11 @@ void ProtocolGame::parsePacket(NetworkMessage& msg)
 		case ClientCode::LookInBattleList: parseLookInBattleList(msg); break;
 		case ClientCode::JoinAggression: /* join aggression */ break;
 		case ClientCode::Say: parseSay(msg); break;
-		case ClientCode::RequestChannels: addGameTask([player_id]() { g_game.playerRequestChannels(player_id); }); break;
+		case ClientCode::RequestChannels: addGameTask("Game::playerRequestChannels", [player_id]() { g_game.playerRequestChannels(player_id); }); break;
 		case ClientCode::OpenChannel: parseOpenChannel(msg); break;
 		case ClientCode::CloseChannel: parseCloseChannel(msg); break;
 		case ClientCode::OpenPrivateChannel: parseOpenPrivateChannel(msg); break;
-		case ClientCode::CloseNpcChannel: addGameTask([player_id]() { g_game.playerCloseNpcChannel(player_id); }); break;
+		case ClientCode::CloseNpcChannel: addGameTask("Game::playerCloseNpcChannel", [player_id]() { g_game.playerCloseNpcChannel(player_id); }); break;
 		case ClientCode::FightMode: parseFightModes(msg); break;
 		case ClientCode::Attack: parseAttack(msg); break;
 		case ClientCode::Follow: parseFollow(msg); break;
@@ -670,17 +680,17 @@ void ProtocolGame::parsePacket(NetworkMessage& msg)
 		case ClientCode::JoinParty: parseJoinParty(msg); break;
 		case ClientCode::RevokePartyInvite: parseRevokePartyInvite(msg); break;
 		case ClientCode::PassPartyLeadership: parsePassPartyLeadership(msg); break;
-		case ClientCode::LeaveParty: addGameTask([player_id]() { g_game.playerLeaveParty(player_id); }); break;
+		case ClientCode::LeaveParty: addGameTask("Game::playerLeaveParty", [player_id]() { g_game.playerLeaveParty(player_id); }); break;
 		case ClientCode::EnableSharedPartyExperience: parseEnableSharedPartyExperience(msg); break;
-		case ClientCode::CreatePrivateChannel: addGameTask([player_id]() { g_game.playerCreatePrivateChannel(player_id); }); break;
+		case ClientCode::CreatePrivateChannel: addGameTask("Game::playerCreatePrivateChannel", [player_id]() { g_game.playerCreatePrivateChannel(player_id); }); break;
 		case ClientCode::ChannelInvite: parseChannelInvite(msg); break;
 		case ClientCode::ChannelExclude: parseChannelExclude(msg); break;
-		case ClientCode::CancelAttackAndFollow: addGameTask([player_id]() { g_game.playerCancelAttackAndFollow(player_id); }); break;
+		case ClientCode::CancelAttackAndFollow: addGameTask("Game::playerCancelAttackAndFollow", [player_id]() { g_game.playerCancelAttackAndFollow(player_id); }); break;
 		case ClientCode::UpdateTile: /* update tile */ break;
 		case ClientCode::UpdateContainer: parseUpdateContainer(msg); break;
 		case ClientCode::BrowseField: parseBrowseField(msg); break;
 		case ClientCode::SeekInContainer: parseSeekInContainer(msg); break;
-		case ClientCode::RequestOutfit: addGameTask([player_id]() { g_game.playerRequestOutfit(player_id); }); break;
+		case ClientCode::RequestOutfit: addGameTask("Game::playerRequestOutfit", [player_id]() { g_game.playerRequestOutfit(player_id); }); break;
 		case ClientCode::SetOutfit: parseSetOutfit(msg); break;
 		case ClientCode::ToggleMount: parseToggleMount(msg); break;
 		case ClientCode::AddVip: parseAddVip(msg); break;
@@ -690,7 +700,7 @@ void ProtocolGame::parsePacket(NetworkMessage& msg)
 		case ClientCode::ThankYou: /* thank you */ break;
 		case ClientCode::DebugAssert: parseDebugAssert(msg); break;
 		///new protocol byte maybe? ///case 0xEE: addGameTask([player_id]() { g_game.playerSay(player_id, 0, TALKTYPE_SAY, "", "hi"); }); break;
-		case ClientCode::ShowQuestLog: addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, [player_id]() { g_game.playerShowQuestLog(player_id); }); break;
+		case ClientCode::ShowQuestLog: addGameTaskTimed("Game::playerShowQuestLog", DISPATCHER_TASK_EXPIRATION, [player_id]() { g_game.playerShowQuestLog(player_id); }); break;
 		case ClientCode::QuestLine: parseQuestLine(msg); break;
 		case ClientCode::RuleViolationReport: parseRuleViolationReport(msg); break;
 		case ClientCode::GetObjectInfo: /* get object info */ break;
@@ -937,31 +947,31 @@ bool ProtocolGame::canSee(int32_t x, int32_t y, int32_t z) const
 void ProtocolGame::parseChannelInvite(NetworkMessage& msg)
 {
 	auto name = msg.getString();
-	addGameTask([playerID = player->getID(), name = std::string{ name }]() { g_game.playerChannelInvite(playerID, name); });
+	addGameTask("Game::playerChannelInvite", [playerID = player->getID(), name = std::string{ name }]() { g_game.playerChannelInvite(playerID, name); });
 }
 
 void ProtocolGame::parseChannelExclude(NetworkMessage& msg)
 {
 	auto name = msg.getString();
-	addGameTask([=, playerID = player->getID(), name = std::string{ name }]() { g_game.playerChannelExclude(playerID, name); });
+	addGameTask("Game::playerChannelExclude", [=, playerID = player->getID(), name = std::string{ name }]() { g_game.playerChannelExclude(playerID, name); });
 }
 
 void ProtocolGame::parseOpenChannel(NetworkMessage& msg)
 {
 	uint16_t channelID = msg.get<uint16_t>();
-	addGameTask([=, playerID = player->getID()]() { g_game.playerOpenChannel(playerID, channelID); });
+	addGameTask("Game::playerOpenChannel", [=, playerID = player->getID()]() { g_game.playerOpenChannel(playerID, channelID); });
 }
 
 void ProtocolGame::parseCloseChannel(NetworkMessage& msg)
 {
 	uint16_t channelID = msg.get<uint16_t>();
-	addGameTask([=, playerID = player->getID()]() { g_game.playerCloseChannel(playerID, channelID); });
+	addGameTask("Game::playerCloseChannel", [=, playerID = player->getID()]() { g_game.playerCloseChannel(playerID, channelID); });
 }
 
 void ProtocolGame::parseOpenPrivateChannel(NetworkMessage& msg)
 {
 	auto receiver = msg.getString();
-	addGameTask([playerID = player->getID(), receiver = std::string{ receiver }]() { g_game.playerOpenPrivateChannel(playerID, receiver); });
+	addGameTask("Game::playerOpenPrivateChannel", [playerID = player->getID(), receiver = std::string{ receiver }]() { g_game.playerOpenPrivateChannel(playerID, receiver); });
 }
 
 void ProtocolGame::parseAutoWalk(NetworkMessage& msg)
@@ -998,7 +1008,7 @@ void ProtocolGame::parseAutoWalk(NetworkMessage& msg)
 		return;
 	}
 
-	addGameTask([playerID = player->getID(), path = std::move(path)]() { g_game.playerAutoWalk(playerID, path); });
+	addGameTask("Game::playerAutoWalk", [playerID = player->getID(), path = std::move(path)]() { g_game.playerAutoWalk(playerID, path); });
 }
 
 void ProtocolGame::parseSetOutfit(NetworkMessage& msg)
@@ -1011,13 +1021,13 @@ void ProtocolGame::parseSetOutfit(NetworkMessage& msg)
 	newOutfit.lookFeet = msg.getByte();
 	newOutfit.lookAddons = msg.getByte();
 	newOutfit.lookMount = msg.get<uint16_t>();
-	addGameTask([=, playerID = player->getID()]() { g_game.playerChangeOutfit(playerID, newOutfit); });
+	addGameTask("Game::playerChangeOutfit", [=, playerID = player->getID()]() { g_game.playerChangeOutfit(playerID, newOutfit); });
 }
 
 void ProtocolGame::parseToggleMount(NetworkMessage& msg)
 {
 	bool mount = msg.getByte() != 0;
-	addGameTask([=, playerID = player->getID()]() { g_game.playerToggleMount(playerID, mount); });
+	addGameTask("Game::playerToggleMount", [=, playerID = player->getID()]() { g_game.playerToggleMount(playerID, mount); });
 }
 
 void ProtocolGame::parseUseItem(NetworkMessage& msg)
@@ -1026,7 +1036,7 @@ void ProtocolGame::parseUseItem(NetworkMessage& msg)
 	uint16_t spriteId = msg.get<uint16_t>();
 	uint8_t stackpos = msg.getByte();
 	uint8_t index = msg.getByte();
-	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, [=, playerID = player->getID()]() { g_game.playerUseItem(playerID, pos, stackpos, index, spriteId); });
+	addGameTaskTimed("Game::playerUseItem", DISPATCHER_TASK_EXPIRATION, [=, playerID = player->getID()]() { g_game.playerUseItem(playerID, pos, stackpos, index, spriteId); });
 }
 
 void ProtocolGame::parseUseItemEx(NetworkMessage& msg)
@@ -1037,7 +1047,7 @@ void ProtocolGame::parseUseItemEx(NetworkMessage& msg)
 	Position toPos = msg.getPosition();
 	uint16_t toSpriteId = msg.get<uint16_t>();
 	uint8_t toStackPos = msg.getByte();
-	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, [=, playerID = player->getID()]()
+	addGameTaskTimed("Game::playerUseItemEx", DISPATCHER_TASK_EXPIRATION, [=, playerID = player->getID()]()
 	{
 		g_game.playerUseItemEx(playerID, fromPos, fromStackPos, fromSpriteId, toPos, toStackPos, toSpriteId);
 	});
@@ -1049,7 +1059,7 @@ void ProtocolGame::parseUseWithCreature(NetworkMessage& msg)
 	uint16_t spriteId = msg.get<uint16_t>();
 	uint8_t fromStackPos = msg.getByte();
 	uint32_t creatureId = msg.get<uint32_t>();
-	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, [=, playerID = player->getID()]()
+	addGameTaskTimed("Game::playerUseWithCreature", DISPATCHER_TASK_EXPIRATION, [=, playerID = player->getID()]()
 	{
 		g_game.playerUseWithCreature(playerID, fromPos, fromStackPos, creatureId, spriteId);
 	});
@@ -1058,19 +1068,19 @@ void ProtocolGame::parseUseWithCreature(NetworkMessage& msg)
 void ProtocolGame::parseCloseContainer(NetworkMessage& msg)
 {
 	uint8_t cid = msg.getByte();
-	addGameTask([=, playerID = player->getID()]() { g_game.playerCloseContainer(playerID, cid); });
+	addGameTask("Game::playerCloseContainer", [=, playerID = player->getID()]() { g_game.playerCloseContainer(playerID, cid); });
 }
 
 void ProtocolGame::parseUpArrowContainer(NetworkMessage& msg)
 {
 	uint8_t cid = msg.getByte();
-	addGameTask([=, playerID = player->getID()]() { g_game.playerMoveUpContainer(playerID, cid); });
+	addGameTask("Game::playerMoveUpContainer", [=, playerID = player->getID()]() { g_game.playerMoveUpContainer(playerID, cid); });
 }
 
 void ProtocolGame::parseUpdateContainer(NetworkMessage& msg)
 {
 	uint8_t cid = msg.getByte();
-	addGameTask([=, playerID = player->getID()]() { g_game.playerUpdateContainer(playerID, cid); });
+	addGameTask("Game::playerUpdateContainer", [=, playerID = player->getID()]() { g_game.playerUpdateContainer(playerID, cid); });
 }
 
 void ProtocolGame::parseThrow(NetworkMessage& msg)
@@ -1083,7 +1093,7 @@ void ProtocolGame::parseThrow(NetworkMessage& msg)
 
 	if (toPos != fromPos)
 	{
-		addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, [=, playerID = player->getID()]()
+		addGameTaskTimed("Game::playerMoveThing", DISPATCHER_TASK_EXPIRATION, [=, playerID = player->getID()]()
 		{
 			g_game.playerMoveThing(playerID, fromPos, spriteId, fromStackpos, toPos, count);
 		});
@@ -1095,13 +1105,13 @@ void ProtocolGame::parseLookAt(NetworkMessage& msg)
 	Position pos = msg.getPosition();
 	msg.skipBytes(2); // spriteId
 	uint8_t stackpos = msg.getByte();
-	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, [=, playerID = player->getID()]() { g_game.playerLookAt(playerID, pos, stackpos); });
+	addGameTaskTimed("Game::playerLookAt", DISPATCHER_TASK_EXPIRATION, [=, playerID = player->getID()]() { g_game.playerLookAt(playerID, pos, stackpos); });
 }
 
 void ProtocolGame::parseLookInBattleList(NetworkMessage& msg)
 {
 	uint32_t creatureID = msg.get<uint32_t>();
-	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, [=, playerID = player->getID()]() { g_game.playerLookInBattleList(playerID, creatureID); });
+	addGameTaskTimed("Game::playerLookInBattleList", DISPATCHER_TASK_EXPIRATION, [=, playerID = player->getID()]() { g_game.playerLookInBattleList(playerID, creatureID); });
 }
 
 void ProtocolGame::parseSay(NetworkMessage& msg)
@@ -1133,7 +1143,7 @@ void ProtocolGame::parseSay(NetworkMessage& msg)
 		return;
 	}
 
-	addGameTask([=, playerID = player->getID(), receiver = std::string{ receiver }, text = std::string{ text }]()
+	addGameTask("Game::playerSay", [=, playerID = player->getID(), receiver = std::string{ receiver }, text = std::string{ text }]()
 	{
 		g_game.playerSay(playerID, channelId, type, receiver, text);
 	});
@@ -1160,21 +1170,21 @@ void ProtocolGame::parseFightModes(NetworkMessage& msg)
 		fightMode = FIGHTMODE_DEFENSE;
 	}
 
-	addGameTask([=, playerID = player->getID()]() { g_game.playerSetFightModes(playerID, fightMode, rawChaseMode != 0, rawSecureMode != 0); });
+	addGameTask("Game::playerSetFightModes", [=, playerID = player->getID()]() { g_game.playerSetFightModes(playerID, fightMode, rawChaseMode != 0, rawSecureMode != 0); });
 }
 
 void ProtocolGame::parseAttack(NetworkMessage& msg)
 {
 	uint32_t creatureID = msg.get<uint32_t>();
 	// msg.get<uint32_t>(); creatureID (same as above)
-	addGameTask([=, playerID = player->getID()]() { g_game.playerSetAttackedCreature(playerID, creatureID); });
+	addGameTask("Game::playerSetAttackedCreature", [=, playerID = player->getID()]() { g_game.playerSetAttackedCreature(playerID, creatureID); });
 }
 
 void ProtocolGame::parseFollow(NetworkMessage& msg)
 {
 	uint32_t creatureID = msg.get<uint32_t>();
 	// msg.get<uint32_t>(); creatureID (same as above)
-	addGameTask([=, playerID = player->getID()]() { g_game.playerFollowCreature(playerID, creatureID); });
+	addGameTask("Game::playerFollowCreature", [=, playerID = player->getID()]() { g_game.playerFollowCreature(playerID, creatureID); });
 }
 
 void ProtocolGame::parseEquipObject(NetworkMessage& msg)
@@ -1182,7 +1192,7 @@ void ProtocolGame::parseEquipObject(NetworkMessage& msg)
 	uint16_t spriteID = msg.get<uint16_t>();
 	// msg.get<uint8_t>();
 
-	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, [=, playerID = player->getID()]() { g_game.playerEquipItem(playerID, spriteID); });
+	addGameTaskTimed("Game::playerEquipItem", DISPATCHER_TASK_EXPIRATION, [=, playerID = player->getID()]() { g_game.playerEquipItem(playerID, spriteID); });
 }
 
 void ProtocolGame::parseTextWindow(NetworkMessage& msg)
@@ -1191,17 +1201,17 @@ void ProtocolGame::parseTextWindow(NetworkMessage& msg)
 	auto newText = msg.getString();
 	if (not player->isAccountManager())
 	{
-		addGameTask([playerID = player->getID(), windowTextID, newText = std::string{ newText }]() { g_game.playerWriteItem(playerID, windowTextID, newText); });
+		addGameTask("Game::playerWriteItem", [playerID = player->getID(), windowTextID, newText = std::string{ newText }]() { g_game.playerWriteItem(playerID, windowTextID, newText); });
 	}
 	else
 	{
 		if (player->getAccount() == 1)
 		{
-			addGameTask([windowTextID, playerID = player->getID(), newText = std::string{ newText }]() { g_game.onAccountManagerRecieveText(playerID, windowTextID, newText); });
+			addGameTask("Game::onAccountManagerRecieveText", [windowTextID, playerID = player->getID(), newText = std::string{ newText }]() { g_game.onAccountManagerRecieveText(playerID, windowTextID, newText); });
 		} 
 		else
 		{
-			addGameTask([windowTextID, playerID = player->getID(), newText = std::string{ newText }]() { g_game.onPrivateAccountManagerRecieveText(playerID, windowTextID, newText); });
+			addGameTask("Game::onPrivateAccountManagerRecieveText", [windowTextID, playerID = player->getID(), newText = std::string{ newText }]() { g_game.onPrivateAccountManagerRecieveText(playerID, windowTextID, newText); });
 		}
 	}
 }
@@ -1211,7 +1221,7 @@ void ProtocolGame::parseHouseWindow(NetworkMessage& msg)
 	uint8_t doorId = msg.getByte();
 	uint32_t id = msg.get<uint32_t>();
 	auto text = msg.getString();
-	addGameTask([=, playerID = player->getID(), text = std::string{ text }]() { g_game.playerUpdateHouseWindow(playerID, doorId, id, text); });
+	addGameTask("Game::playerUpdateHouseWindow", [=, playerID = player->getID(), text = std::string{ text }]() { g_game.playerUpdateHouseWindow(playerID, doorId, id, text); });
 }
 
 void ProtocolGame::parseWrapItem(NetworkMessage& msg)
@@ -1219,14 +1229,14 @@ void ProtocolGame::parseWrapItem(NetworkMessage& msg)
 	Position pos = msg.getPosition();
 	uint16_t spriteId = msg.get<uint16_t>();
 	uint8_t stackpos = msg.getByte();
-	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, [=, playerID = player->getID()]() { g_game.playerWrapItem(playerID, pos, stackpos, spriteId); });
+	addGameTaskTimed("Game::playerWrapItem", DISPATCHER_TASK_EXPIRATION, [=, playerID = player->getID()]() { g_game.playerWrapItem(playerID, pos, stackpos, spriteId); });
 }
 
 void ProtocolGame::parseLookInShop(NetworkMessage& msg)
 {
 	uint16_t id = msg.get<uint16_t>();
 	uint8_t count = msg.getByte();
-	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, [=, playerID = player->getID()]() { g_game.playerLookInShop(playerID, id, count); });
+	addGameTaskTimed("Game::playerLookInShop", DISPATCHER_TASK_EXPIRATION, [=, playerID = player->getID()]() { g_game.playerLookInShop(playerID, id, count); });
 }
 
 void ProtocolGame::parsePlayerPurchase(NetworkMessage& msg)
@@ -1236,7 +1246,7 @@ void ProtocolGame::parsePlayerPurchase(NetworkMessage& msg)
 	uint8_t amount = msg.getByte();
 	bool ignoreCap = msg.getByte() != 0;
 	bool inBackpacks = msg.getByte() != 0;
-	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, [=, playerID = player->getID()]()
+	addGameTaskTimed("Game::playerPurchaseItem", DISPATCHER_TASK_EXPIRATION, [=, playerID = player->getID()]()
 	{
 		g_game.playerPurchaseItem(playerID, id, count, amount, ignoreCap, inBackpacks);
 	});
@@ -1248,7 +1258,7 @@ void ProtocolGame::parsePlayerSale(NetworkMessage& msg)
 	uint8_t count = msg.getByte();
 	uint8_t amount = msg.getByte();
 	bool ignoreEquipped = msg.getByte() != 0;
-	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, [=, playerID = player->getID()]() { g_game.playerSellItem(playerID, id, count, amount, ignoreEquipped); });
+	addGameTaskTimed("Game::playerSellItem", DISPATCHER_TASK_EXPIRATION, [=, playerID = player->getID()]() { g_game.playerSellItem(playerID, id, count, amount, ignoreEquipped); });
 }
 
 void ProtocolGame::parseRequestTrade(NetworkMessage& msg)
@@ -1257,26 +1267,26 @@ void ProtocolGame::parseRequestTrade(NetworkMessage& msg)
 	uint16_t spriteId = msg.get<uint16_t>();
 	uint8_t stackpos = msg.getByte();
 	uint32_t playerId = msg.get<uint32_t>();
-	addGameTask([=, playerID = player->getID()]() { g_game.playerRequestTrade(playerID, pos, stackpos, playerId, spriteId); });
+	addGameTask("Game::playerRequestTrade", [=, playerID = player->getID()]() { g_game.playerRequestTrade(playerID, pos, stackpos, playerId, spriteId); });
 }
 
 void ProtocolGame::parseLookInTrade(NetworkMessage& msg)
 {
 	bool counterOffer = (static_cast<ClientCode>(msg.getByte()) == ClientCode::CounterOffer);
 	uint8_t index = msg.getByte();
-	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, [=, playerID = player->getID()]() { g_game.playerLookInTrade(playerID, counterOffer, index); });
+	addGameTaskTimed("Game::playerLookInTrade", DISPATCHER_TASK_EXPIRATION, [=, playerID = player->getID()]() { g_game.playerLookInTrade(playerID, counterOffer, index); });
 }
 
 void ProtocolGame::parseAddVip(NetworkMessage& msg)
 {
 	auto name = msg.getString();
-	addGameTask([playerID = player->getID(), name = std::string{ name }]() { g_game.playerRequestAddVip(playerID, name); });
+	addGameTask("Game::playerRequestAddVip", [playerID = player->getID(), name = std::string{ name }]() { g_game.playerRequestAddVip(playerID, name); });
 }
 
 void ProtocolGame::parseRemoveVip(NetworkMessage& msg)
 {
 	uint32_t guid = msg.get<uint32_t>();
-	addGameTask([=, playerID = player->getID()]() { g_game.playerRequestRemoveVip(playerID, guid); });
+	addGameTask("Game::playerRequestRemoveVip", [=, playerID = player->getID()]() { g_game.playerRequestRemoveVip(playerID, guid); });
 }
 
 void ProtocolGame::parseEditVip(NetworkMessage& msg)
@@ -1285,7 +1295,7 @@ void ProtocolGame::parseEditVip(NetworkMessage& msg)
 	auto description = msg.getString();
 	uint32_t icon = std::min<uint32_t>(10, msg.get<uint32_t>()); // 10 is max icon in 9.63
 	bool notify = msg.getByte() != 0;
-	addGameTask([=, playerID = player->getID(), description = std::string{ description }]() { g_game.playerRequestEditVip(playerID, guid, description, icon, notify); });
+	addGameTask("Game::playerRequestEditVip", [=, playerID = player->getID(), description = std::string{ description }]() { g_game.playerRequestEditVip(playerID, guid, description, icon, notify); });
 }
 
 void ProtocolGame::parseRotateItem(NetworkMessage& msg)
@@ -1293,7 +1303,7 @@ void ProtocolGame::parseRotateItem(NetworkMessage& msg)
 	Position pos = msg.getPosition();
 	uint16_t spriteId = msg.get<uint16_t>();
 	uint8_t stackpos = msg.getByte();
-	addGameTaskTimed(DISPATCHER_TASK_EXPIRATION, [=, playerID = player->getID()]() { g_game.playerRotateItem(playerID, pos, stackpos, spriteId); });
+	addGameTaskTimed("Game::playerRotateItem", DISPATCHER_TASK_EXPIRATION, [=, playerID = player->getID()]() { g_game.playerRotateItem(playerID, pos, stackpos, spriteId); });
 }
 
 void ProtocolGame::parseRuleViolationReport(NetworkMessage& msg)
@@ -1313,7 +1323,7 @@ void ProtocolGame::parseRuleViolationReport(NetworkMessage& msg)
 		msg.get<uint32_t>(); // statement id, used to get whatever player have said, we don't log that.
 	}
 
-	addGameTask([=, playerID = player->getID(), targetName = std::string{ targetName }, comment = std::string{ comment }, translation = std::string{ translation }]()
+	addGameTask("Game::playerReportRuleViolation", [=, playerID = player->getID(), targetName = std::string{ targetName }, comment = std::string{ comment }, translation = std::string{ translation }]()
 	{
 		g_game.playerReportRuleViolation(playerID, targetName, reportType, reportReason, comment, translation);
 	});
@@ -1329,7 +1339,7 @@ void ProtocolGame::parseBugReport(NetworkMessage& msg)
 		position = msg.getPosition();
 	}
 
-	addGameTask([=, playerID = player->getID(), message = std::string{ message }]() { g_game.playerReportBug(playerID, message, position, category); });
+	addGameTask("Game::playerReportBug", [=, playerID = player->getID(), message = std::string{ message }]() { g_game.playerReportBug(playerID, message, position, category); });
 }
 
 void ProtocolGame::parseDebugAssert(NetworkMessage& msg)
@@ -1345,7 +1355,7 @@ void ProtocolGame::parseDebugAssert(NetworkMessage& msg)
 	auto date = msg.getString();
 	auto description = msg.getString();
 	auto comment = msg.getString();
-	addGameTask([playerID = player->getID(), assertLine = std::string{ assertLine }, date = std::string{ date }, description = std::string{ description }, comment = std::string{ comment }]()
+	addGameTask("Game::playerDebugAssert", [playerID = player->getID(), assertLine = std::string{ assertLine }, date = std::string{ date }, description = std::string{ description }, comment = std::string{ comment }]()
 	{
 		g_game.playerDebugAssert(playerID, assertLine, date, description, comment);
 	});
@@ -1354,42 +1364,42 @@ void ProtocolGame::parseDebugAssert(NetworkMessage& msg)
 void ProtocolGame::parseInviteToParty(NetworkMessage& msg)
 {
 	uint32_t targetID = msg.get<uint32_t>();
-	addGameTask([=, playerID = player->getID()]() { g_game.playerInviteToParty(playerID, targetID); });
+	addGameTask("Game::playerInviteToParty", [=, playerID = player->getID()]() { g_game.playerInviteToParty(playerID, targetID); });
 }
 
 void ProtocolGame::parseJoinParty(NetworkMessage& msg)
 {
 	uint32_t targetID = msg.get<uint32_t>();
-	addGameTask([=, playerID = player->getID()]() { g_game.playerJoinParty(playerID, targetID); });
+	addGameTask("Game::playerJoinParty", [=, playerID = player->getID()]() { g_game.playerJoinParty(playerID, targetID); });
 }
 
 void ProtocolGame::parseRevokePartyInvite(NetworkMessage& msg)
 {
 	uint32_t targetID = msg.get<uint32_t>();
-	addGameTask([=, playerID = player->getID()]() { g_game.playerRevokePartyInvitation(playerID, targetID); });
+	addGameTask("Game::playerRevokePartyInvitation", [=, playerID = player->getID()]() { g_game.playerRevokePartyInvitation(playerID, targetID); });
 }
 
 void ProtocolGame::parsePassPartyLeadership(NetworkMessage& msg)
 {
 	uint32_t targetID = msg.get<uint32_t>();
-	addGameTask([=, playerID = player->getID()]() { g_game.playerPassPartyLeadership(playerID, targetID); });
+	addGameTask("Game::playerPassPartyLeadership", [=, playerID = player->getID()]() { g_game.playerPassPartyLeadership(playerID, targetID); });
 }
 
 void ProtocolGame::parseEnableSharedPartyExperience(NetworkMessage& msg)
 {
 	bool sharedExpActive = msg.getByte() == 1;
-	addGameTask([=, playerID = player->getID()]() { g_game.playerEnableSharedPartyExperience(playerID, sharedExpActive); });
+	addGameTask("Game::playerEnableSharedPartyExperience", [=, playerID = player->getID()]() { g_game.playerEnableSharedPartyExperience(playerID, sharedExpActive); });
 }
 
 void ProtocolGame::parseQuestLine(NetworkMessage& msg)
 {
 	uint16_t questID = msg.get<uint16_t>();
-	addGameTask([=, playerID = player->getID()]() { g_game.playerShowQuestLine(playerID, questID); });
+	addGameTask("Game::playerShowQuestLine", [=, playerID = player->getID()]() { g_game.playerShowQuestLine(playerID, questID); });
 }
 
 void ProtocolGame::parseMarketLeave()
 {
-	addGameTask([playerID = player->getID()]() { g_game.playerLeaveMarket(playerID); });
+	addGameTask("Game::playerLeaveMarket", [playerID = player->getID()]() { g_game.playerLeaveMarket(playerID); });
 }
 
 void ProtocolGame::parseMarketBrowse(NetworkMessage& msg)
@@ -1416,14 +1426,14 @@ void ProtocolGame::parseMarketCreateOffer(NetworkMessage& msg)
 	uint16_t amount = msg.get<uint16_t>();
 	uint32_t price = msg.get<uint32_t>();
 	bool anonymous = (msg.getByte() != 0);
-	addGameTask([=, playerID = player->getID()]() { g_game.playerCreateMarketOffer(playerID, type, spriteId, amount, price, anonymous); });
+	addGameTask("Game::playerCreateMarketOffer", [=, playerID = player->getID()]() { g_game.playerCreateMarketOffer(playerID, type, spriteId, amount, price, anonymous); });
 }
 
 void ProtocolGame::parseMarketCancelOffer(NetworkMessage& msg)
 {
 	uint32_t timestamp = msg.get<uint32_t>();
 	uint16_t counter = msg.get<uint16_t>();
-	addGameTask([=, playerID = player->getID()]() { g_game.playerCancelMarketOffer(playerID, timestamp, counter); });
+	addGameTask("Game::playerCancelMarketOffer", [=, playerID = player->getID()]() { g_game.playerCancelMarketOffer(playerID, timestamp, counter); });
 }
 
 void ProtocolGame::parseMarketAcceptOffer(NetworkMessage& msg)
@@ -1431,7 +1441,7 @@ void ProtocolGame::parseMarketAcceptOffer(NetworkMessage& msg)
 	uint32_t timestamp = msg.get<uint32_t>();
 	uint16_t counter = msg.get<uint16_t>();
 	uint16_t amount = msg.get<uint16_t>();
-	addGameTask([=, playerID = player->getID()]() { g_game.playerAcceptMarketOffer(playerID, timestamp, counter, amount); });
+	addGameTask("Game::playerAcceptMarketOffer", [=, playerID = player->getID()]() { g_game.playerAcceptMarketOffer(playerID, timestamp, counter, amount); });
 }
 
 void ProtocolGame::parseModalWindowAnswer(NetworkMessage& msg)
@@ -1439,20 +1449,20 @@ void ProtocolGame::parseModalWindowAnswer(NetworkMessage& msg)
 	uint32_t id = msg.get<uint32_t>();
 	uint8_t button = msg.getByte();
 	uint8_t choice = msg.getByte();
-	addGameTask([=, playerID = player->getID()]() { g_game.playerAnswerModalWindow(playerID, id, button, choice); });
+	addGameTask("Game::playerAnswerModalWindow", [=, playerID = player->getID()]() { g_game.playerAnswerModalWindow(playerID, id, button, choice); });
 }
 
 void ProtocolGame::parseBrowseField(NetworkMessage& msg)
 {
 	Position pos = msg.getPosition();
-	addGameTask([=, playerID = player->getID()]() { g_game.playerBrowseField(playerID, pos); });
+	addGameTask("Game::playerBrowseField", [=, playerID = player->getID()]() { g_game.playerBrowseField(playerID, pos); });
 }
 
 void ProtocolGame::parseSeekInContainer(NetworkMessage& msg)
 {
 	uint8_t containerId = msg.getByte();
 	uint16_t index = msg.get<uint16_t>();
-	addGameTask([=, playerID = player->getID()]() { g_game.playerSeekInContainer(playerID, containerId, index); });
+	addGameTask("Game::playerSeekInContainer", [=, playerID = player->getID()]() { g_game.playerSeekInContainer(playerID, containerId, index); });
 }
 
 // Send methods
@@ -2595,21 +2605,28 @@ void ProtocolGame::sendCreatureTurn(const CreatureConstPtr& creature, uint32_t s
 void ProtocolGame::sendCreatureSay(const CreatureConstPtr& creature, SpeakClasses type, const std::string& text, const Position* pos/* = nullptr*/)
 {
 	NetworkMessage msg;
+	AddCreatureSay(msg, creature, type, text, pos);
+	writeToOutputBuffer(msg);
+}
+
+template<typename Message>
+void ProtocolGame::AddCreatureSay(Message& msg, const CreatureConstPtr& creature, SpeakClasses type, const std::string& text, const Position* pos)
+{
 	msg.add(ServerCode::CreatureSay);
 
 	static uint32_t statementId = 0;
-	msg.add<uint32_t>(++statementId);
+	msg.add(static_cast<uint32_t>(++statementId));
 
 	msg.addString(creature->getName());
 
 	//Add level only for players
 	if (const auto& speaker = creature->getPlayer())
 	{
-		msg.add<uint16_t>(speaker->getLevel());
+		msg.add(static_cast<uint16_t>(speaker->getLevel()));
 	}
 	else
 	{
-		msg.add<SpecialCode>(SpecialCode::Zero);
+		msg.add(SpecialCode::Zero);
 	}
 
 	msg.addByte(type);
@@ -2624,8 +2641,8 @@ void ProtocolGame::sendCreatureSay(const CreatureConstPtr& creature, SpeakClasse
 	}
 
 	msg.addString(text);
-	writeToOutputBuffer(msg);
 }
+template void ProtocolGame::AddCreatureSay(PacketBuffer& msg, const CreatureConstPtr& creature, SpeakClasses type, const std::string& text, const Position* pos);
 
 void ProtocolGame::sendToChannel(const CreatureConstPtr& creature, SpeakClasses type, const std::string& text, uint16_t channelId)
 {
@@ -2727,13 +2744,18 @@ void ProtocolGame::sendPingBack()
 
 void ProtocolGame::sendDistanceShoot(const Position& from, const Position& to, uint8_t type)
 {
-	NetworkMessage msg;
+	AddDistanceShoot(startPacket(12), from, to, type);
+}
+
+template<typename Message>
+void ProtocolGame::AddDistanceShoot(Message& msg, const Position& from, const Position& to, uint8_t type)
+{
 	msg.add(ServerCode::DistanceShoot);
 	msg.addPosition(from);
 	msg.addPosition(to);
 	msg.addByte(type);
-	writeToOutputBuffer(msg);
 }
+template void ProtocolGame::AddDistanceShoot(PacketBuffer& msg, const Position& from, const Position& to, uint8_t type);
 
 void ProtocolGame::sendMagicEffect(const Position& pos, uint8_t type)
 {
@@ -2741,18 +2763,37 @@ void ProtocolGame::sendMagicEffect(const Position& pos, uint8_t type)
 		return;
 	}
 
-	NetworkMessage msg;
+	AddMagicEffect(startPacket(7), pos, type);
+}
+
+void ProtocolGame::sendMagicEffect(const PacketBuffer& packet, const Position& pos)
+{
+	if (not canSee(pos)) {
+		return;
+	}
+
+	writePacket(packet);
+}
+
+template<typename Message>
+void ProtocolGame::AddMagicEffect(Message& msg, const Position& pos, uint8_t type)
+{
 	msg.add(ServerCode::MagicEffect);
 	msg.addPosition(pos);
 	msg.addByte(type);
-	writeToOutputBuffer(msg);
 }
+template void ProtocolGame::AddMagicEffect(PacketBuffer& msg, const Position& pos, uint8_t type);
 
 void ProtocolGame::sendCreatureHealth(const CreatureConstPtr& creature)
 {
-	NetworkMessage msg;
+	AddCreatureHealth(startPacket(6), creature);
+}
+
+template<typename Message>
+void ProtocolGame::AddCreatureHealth(Message& msg, const CreatureConstPtr& creature)
+{
 	msg.add(ServerCode::CreatureHealth);
-	msg.add<uint32_t>(creature->getID());
+	msg.add(static_cast<uint32_t>(creature->getID()));
 
 	if (creature->isHealthHidden())
 	{
@@ -2762,8 +2803,8 @@ void ProtocolGame::sendCreatureHealth(const CreatureConstPtr& creature)
 	{
 		msg.addByte(std::ceil((static_cast<double>(creature->getHealth()) / std::max<int32_t>(creature->getMaxHealth(), 1)) * 100));
 	}
-	writeToOutputBuffer(msg);
 }
+template void ProtocolGame::AddCreatureHealth(PacketBuffer& msg, const CreatureConstPtr& creature);
 
 void ProtocolGame::sendFYIBox(const std::string& message)
 {
@@ -2790,12 +2831,12 @@ void ProtocolGame::sendAddTileItem(const Position& pos, uint32_t stackpos, const
 		return;
 	}
 
-	NetworkMessage msg;
+	// the item takes at most 5 bytes
+	NetworkMessage& msg = startPacket(12);
 	msg.add(ServerCode::AddTileThing);
 	msg.addPosition(pos);
 	msg.addByte(stackpos);
 	msg.addItem(item);
-	writeToOutputBuffer(msg);
 }
 
 void ProtocolGame::sendUpdateTileItem(const Position& pos, uint32_t stackpos, const ItemConstPtr& item)
@@ -3102,7 +3143,7 @@ void ProtocolGame::sendMoveCreature(const CreatureConstPtr& creature, const Posi
 		}
 		else
 		{
-			NetworkMessage msg;
+			NetworkMessage& msg = startPacket(1 + sizeof(SpecialCode) + sizeof(uint32_t) + 5);
 			msg.add(ServerCode::MoveCreature);
 			if (oldStackPos < 10)
 			{
@@ -3115,7 +3156,6 @@ void ProtocolGame::sendMoveCreature(const CreatureConstPtr& creature, const Posi
 				msg.add<uint32_t>(creature->getID());
 			}
 			msg.addPosition(creature->getPosition());
-			writeToOutputBuffer(msg);
 		}
 	}
 	else if (canSee(oldPos))
@@ -3794,5 +3834,5 @@ void ProtocolGame::parseExtendedOpcode(NetworkMessage& msg)
 	auto buffer = msg.getString();
 
 	// process additional opcodes via lua script event
-	addGameTask([=, playerID = player->getID(), buffer = std::string{ buffer }]() { g_game.parsePlayerExtendedOpcode(playerID, opcode, buffer); });
+	addGameTask("Game::parsePlayerExtendedOpcode", [=, playerID = player->getID(), buffer = std::string{ buffer }]() { g_game.parsePlayerExtendedOpcode(playerID, opcode, buffer); });
 }
@@ -57,6 +57,17 @@ class ProtocolGame final : public Protocol
 			return version;
 		}
 
+		// broadcasts encode their packet once into a PacketBuffer with these and every
+		// spectator only gets the bytes copied into its output buffer
+		template<typename Message>
+		static void AddDistanceShoot(Message& msg, const Position& from, const Position& to, uint8_t type);
+		template<typename Message>
+		static void AddMagicEffect(Message& msg, const Position& pos, uint8_t type);
+		template<typename Message>
+		static void AddCreatureHealth(Message& msg, const CreatureConstPtr& creature);
+		template<typename Message>
+		static void AddCreatureSay(Message& msg, const CreatureConstPtr& creature, SpeakClasses type, const std::string& text, const Position* pos);
+
 	private:
 		ProtocolGame_ptr getThis() {
 			return std::static_pointer_cast<ProtocolGame>(shared_from_this());
@@ -65,6 +76,11 @@ class ProtocolGame final : public Protocol
 		void disconnectClient(const std::string& message) const;
 		void writeToOutputBuffer(const NetworkMessage& msg);
 
+		// the output buffer with room for a packet of up to maxSize bytes, small fixed size
+		// packets are written straight into it instead of being copied from a NetworkMessage
+		NetworkMessage& startPacket(int32_t maxSize);
+		void writePacket(const PacketBuffer& packet);
+
 		void release() override;
 
 		void checkCreatureAsKnown(uint32_t id, bool& known, uint32_t& removedKnown);
@@ -163,6 +179,7 @@ class ProtocolGame final : public Protocol
 
 		void sendDistanceShoot(const Position& from, const Position& to, uint8_t type);
 		void sendMagicEffect(const Position& pos, uint8_t type);
+		void sendMagicEffect(const PacketBuffer& packet, const Position& pos);
 		void sendCreatureHealth(const CreatureConstPtr& creature);
 		void sendSkills();
 		void sendPing();
@@ -355,14 +372,15 @@ class ProtocolGame final : public Protocol
 		friend class Player;
 
 		// Helpers so we don't need to bind every time
+		// tag names the task in the dispatcher profiler
 		template <typename Callable>
-		void addGameTask(Callable&& function) {
-			g_dispatcher.addTask(createTask(std::forward<Callable>(function)));
+		void addGameTask(const char* tag, Callable&& function) {
+			g_dispatcher.addTask(createTask(tag, std::forward<Callable>(function)));
 		}
 
 		template <typename Callable>
-		void addGameTaskTimed(uint32_t delay, Callable&& function) {
-			g_dispatcher.addTask(createTask(delay, std::forward<Callable>(function)));
+		void addGameTaskTimed(const char* tag, uint32_t delay, Callable&& function) {
+			g_dispatcher.addTask(createTask(tag, delay, std::forward<Callable>(function)));
 		}
 
 		std::unordered_set<uint32_t> knownCreatureSet;
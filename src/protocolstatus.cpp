@@ -11,6 +11,7 @@
 extern ConfigManager g_config;
 extern Game g_game;
 
+std::mutex ProtocolStatus::ipConnectMapLock;
 std::map<uint32_t, int64_t> ProtocolStatus::ipConnectMap;
 const uint64_t ProtocolStatus::start = OTSYS_TIME();
 
@@ -28,18 +29,21 @@ enum RequestedInfo_t : uint16_t {
 void ProtocolStatus::onRecvFirstMessage(NetworkMessage& msg)
 {
 	uint32_t ip = getIP();
-	if (ip != 0x0100007F) {
-		std::string ipStr = convertIPToString(ip);
-		if (ipStr != g_config.getString(ConfigManager::IP)) {
-			std::map<uint32_t, int64_t>::const_iterator it = ipConnectMap.find(ip);
-			if (it != ipConnectMap.end() && (OTSYS_TIME() < (it->second + g_config.getNumber(ConfigManager::STATUSQUERY_TIMEOUT)))) {
-				disconnect();
-				return;
+	{
+		std::lock_guard<std::mutex> lockClass(ipConnectMapLock);
+		if (ip != 0x0100007F) {
+			std::string ipStr = convertIPToString(ip);
+			if (ipStr != g_config.getString(ConfigManager::IP)) {
+				std::map<uint32_t, int64_t>::const_iterator it = ipConnectMap.find(ip);
+				if (it != ipConnectMap.end() && (OTSYS_TIME() < (it->second + g_config.getNumber(ConfigManager::STATUSQUERY_TIMEOUT)))) {
+					disconnect();
+					return;
+				}
 			}
 		}
-	}
 
-	ipConnectMap[ip] = OTSYS_TIME();
+		ipConnectMap[ip] = OTSYS_TIME();
+	}
 
 	switch (msg.getByte()) {
 		//XML info protocol
@@ -29,6 +29,8 @@ class ProtocolStatus final : public Protocol
 		static const uint64_t start;
 
 	private:
+		// first messages are parsed on every network thread
+		static std::mutex ipConnectMapLock;
 		static std::map<uint32_t, int64_t> ipConnectMap;
 };
 
@@ -12,7 +12,8 @@
 #include <fstream>
 #include <sstream>
 
-static CryptoPP::AutoSeededRandomPool prng;
+// first messages are decrypted on every network thread and the pool is not thread-safe
+static thread_local CryptoPP::AutoSeededRandomPool prng;
 
 void RSA::decrypt(char* msg) const
 {
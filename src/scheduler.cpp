@@ -15,27 +15,88 @@ uint32_t Scheduler::addEvent(SchedulerTask* task)
 	}
 
 	boost::asio::post(io_context, [this, task]() {
-		// insert the event id in the list of active events
-		auto it = eventIdTimerMap.emplace(task->getEventId(), boost::asio::steady_timer{io_context});
-		auto& timer = it.first->second;
-
-		timer.expires_after(std::chrono::milliseconds(task->getDelay()));
-		timer.async_wait([this, task](const boost::system::error_code& error) {
-			eventIdTimerMap.erase(task->getEventId());
-
-			if (error == boost::asio::error::operation_aborted || getState() == THREAD_STATE_TERMINATED) {
-				// the timer has been manually canceled(timer->cancel()) or Scheduler::shutdown has been called
-				delete task;
-				return;
-			}
-
-			g_dispatcher.addTask(task);
-		});
+		if (useTimerWheel) {
+			addWheelEvent(task);
+		} else {
+			addTimerEvent(task);
+		}
 	});
 
 	return task->getEventId();
 }
 
+void Scheduler::addTimerEvent(SchedulerTask* task)
+{
+	// insert the event id in the list of active events
+	auto it = eventIdTimerMap.emplace(task->getEventId(), boost::asio::steady_timer{io_context});
+	auto& timer = it.first->second;
+
+	timer.expires_after(std::chrono::milliseconds(task->getDelay()));
+	timer.async_wait([this, task](const boost::system::error_code& error) {
+		eventIdTimerMap.erase(task->getEventId());
+
+		if (error == boost::asio::error::operation_aborted || getState() == THREAD_STATE_TERMINATED) {
+			// the timer has been manually canceled(timer->cancel()) or Scheduler::shutdown has been called
+			delete task;
+			return;
+		}
+
+		g_dispatcher.addTask(task);
+	});
+}
+
+void Scheduler::addWheelEvent(SchedulerTask* task)
+{
+	const uint64_t now = getWheelTick();
+	if (timerWheel.empty()) {
+		// the wheel doesn't tick while idle, catch it up before inserting
+		timerWheel.reset(now);
+	}
+
+	timerWheel.insert(task, now + task->getDelay());
+	scheduleWheelTick();
+}
+
+void Scheduler::scheduleWheelTick()
+{
+	if (wheelTimerArmed || timerWheel.empty()) {
+		return;
+	}
+
+	wheelTimerArmed = true;
+	wheelTimer.expires_at(wheelEpoch + std::chrono::milliseconds(timerWheel.getCurrentTick() + 1));
+	wheelTimer.async_wait([this](const boost::system::error_code& error) {
+		wheelTimerArmed = false;
+		if (error == boost::asio::error::operation_aborted || getState() == THREAD_STATE_TERMINATED) {
+			return;
+		}
+
+		onWheelTick();
+	});
+}
+
+void Scheduler::onWheelTick()
+{
+	// every slot that elapsed since the last tick is expired in one batch
+	timerWheel.advance(getWheelTick(), [](SchedulerTask* task) {
+		g_dispatcher.addTask(task);
+	});
+
+	scheduleWheelTick();
+}
+
+uint64_t Scheduler::getWheelTick() const
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - wheelEpoch).count();
+}
+
+void Scheduler::setTimerWheel(bool enabled)
+{
+	boost::asio::post(io_context, [this, enabled]() {
+		useTimerWheel = enabled;
+	});
+}
+
 void Scheduler::stopEvent(uint32_t eventId)
 {
 	if (eventId == 0) {
@@ -43,6 +104,10 @@ void Scheduler::stopEvent(uint32_t eventId)
 	}
 
 	boost::asio::post(io_context, [this, eventId]() {
+		if (timerWheel.cancel(eventId)) {
+			return;
+		}
+
 		// search the event id
 		auto it = eventIdTimerMap.find(eventId);
 		if (it != eventIdTimerMap.end()) {
@@ -60,11 +125,9 @@ void Scheduler::shutdown()
 			it.second.cancel();
 		}
 
+		timerWheel.clear();
+		wheelTimer.cancel();
+
 		io_context.stop();
 	});
 }
-
-SchedulerTask* createSchedulerTask(uint32_t delay, TaskFunc&& f)
-{
-	return new SchedulerTask(delay, std::move(f));
-}
@@ -6,6 +6,7 @@
 
 #include "tasks.h"
 #include "thread_holder_base.h"
+#include "timerwheel.h"
 
 #include <gtl/phmap.hpp>
 
@@ -27,15 +28,33 @@ class SchedulerTask : public Task
 		}
 	
 	private:
-		SchedulerTask(uint32_t delay, TaskFunc&& f) : Task(std::move(f)), delay(delay) {}
+		template <TaskCallable F>
+		SchedulerTask(uint32_t delay, F&& f) : Task(std::forward<F>(f)), delay(delay) {}
 
 		uint32_t eventId = 0;
 		uint32_t delay = 0;
 
-		friend SchedulerTask* createSchedulerTask(uint32_t, TaskFunc&&);
+		template <TaskCallable F>
+		friend SchedulerTask* createSchedulerTask(uint32_t, F&&);
+		template <TaskCallable F>
+		friend SchedulerTask* createSchedulerTask(const char*, uint32_t, F&&);
 };
 
-SchedulerTask* createSchedulerTask(uint32_t delay, TaskFunc&& f);
+static_assert(sizeof(SchedulerTask) <= TASK_POOL_BLOCK_SIZE, "SchedulerTask must fit in a pooled task block");
+
+template <TaskCallable F>
+SchedulerTask* createSchedulerTask(uint32_t delay, F&& f)
+{
+	return new SchedulerTask(delay, std::forward<F>(f));
+}
+
+template <TaskCallable F>
+SchedulerTask* createSchedulerTask(const char* tag, uint32_t delay, F&& f)
+{
+	SchedulerTask* task = new SchedulerTask(delay, std::forward<F>(f));
+	task->setTag(tag);
+	return task;
+}
 
 class Scheduler : public ThreadHolder<Scheduler>
 {
@@ -43,14 +62,32 @@ class Scheduler : public ThreadHolder<Scheduler>
 		uint32_t addEvent(SchedulerTask* task);
 		void stopEvent(uint32_t eventId);
 
+		// switches new events between one asio timer per event and the timer wheel,
+		// events that are already pending finish on the backend they were added to
+		void setTimerWheel(bool enabled);
+
 		void shutdown();
 
 		void threadMain() { io_context.run(); }
 	private:
+		void addTimerEvent(SchedulerTask* task);
+		void addWheelEvent(SchedulerTask* task);
+		void scheduleWheelTick();
+		void onWheelTick();
+
+		uint64_t getWheelTick() const;
+
 		std::atomic<uint32_t> lastEventId{0};
 		gtl::node_hash_map<uint32_t, boost::asio::steady_timer> eventIdTimerMap;
 		boost::asio::io_context io_context;
 		boost::asio::executor_work_guard<boost::asio::io_context::executor_type> work{ io_context.get_executor() };
+
+		// timer wheel backend, driven by a single 1 ms tick timer while events are pending
+		TimerWheel timerWheel;
+		boost::asio::steady_timer wheelTimer{ io_context };
+		const std::chrono::steady_clock::time_point wheelEpoch = std::chrono::steady_clock::now();
+		bool useTimerWheel = false;
+		bool wheelTimerArmed = false;
 };
 
 extern Scheduler g_scheduler;
@@ -20,13 +20,53 @@ ServiceManager::~ServiceManager()
 void ServiceManager::die()
 {
 	io_context.stop();
+	for (auto& context : ioContexts) {
+		context->stop();
+	}
 }
 
 void ServiceManager::run()
 {
 	assert(!running);
 	running = true;
+
+	getNextIOContext();
+	for (auto& context : ioContexts) {
+		ioThreads.emplace_back([&context = *context]() { context.run(); });
+	}
+
 	io_context.run();
+
+	ioWork.clear();
+	for (auto& context : ioContexts) {
+		context->stop();
+	}
+	for (auto& thread : ioThreads) {
+		thread.join();
+	}
+	ioThreads.clear();
+}
+
+boost::asio::io_context& ServiceManager::getNextIOContext()
+{
+	// the pool is created on first use, the acceptors open (and queue their
+	// first connection) from the loader after the config has been read
+	if (!ioContextsCreated) {
+		ioContextsCreated = true;
+
+		const int64_t threads = std::max<int64_t>(1, g_config.getNumber(ConfigManager::NETWORK_THREADS));
+		for (int64_t i = 1; i < threads; ++i) {
+			auto& context = ioContexts.emplace_back(std::make_unique<boost::asio::io_context>());
+			ioWork.emplace_back(boost::asio::make_work_guard(*context));
+		}
+	}
+
+	// only called from the acceptors, which all run on the main context
+	const size_t index = nextIOContext++ % (ioContexts.size() + 1);
+	if (index == 0) {
+		return io_context;
+	}
+	return *ioContexts[index - 1];
 }
 
 void ServiceManager::stop()
@@ -82,7 +122,7 @@ void ServicePort::accept()
 		return;
 	}
 
-	auto connection = ConnectionManager::getInstance().createConnection(io_context, shared_from_this());
+	auto connection = ConnectionManager::getInstance().createConnection(manager.getNextIOContext(), shared_from_this());
 	acceptor->async_accept(connection->getSocket(), [=, thisPtr = shared_from_this()](const boost::system::error_code& error) { thisPtr->onAccept(connection, error); });
 }
 
@@ -95,11 +135,12 @@ void ServicePort::onAccept(const Connection_ptr& connection, const boost::system
 
 		auto remote_ip = connection->getIP();
 		if (remote_ip != 0 && g_bans.acceptConnection(remote_ip)) {
+			// start reading on the connection's own context
 			Service_ptr service = services.front();
 			if (service->is_single_socket()) {
-				connection->accept(service->make_protocol(connection));
+				boost::asio::post(connection->getSocket().get_executor(), [connection, protocol = service->make_protocol(connection)]() { connection->accept(protocol); });
 			} else {
-				connection->accept();
+				boost::asio::post(connection->getSocket().get_executor(), [connection]() { connection->accept(); });
 			}
 		} else {
 			connection->close(Connection::FORCE_CLOSE);
@@ -110,7 +151,7 @@ void ServicePort::onAccept(const Connection_ptr& connection, const boost::system
 		if (!pendingStart) {
 			close();
 			pendingStart = true;
-			g_scheduler.addEvent(createSchedulerTask(15000, [=, thisPtr = std::weak_ptr<ServicePort>(shared_from_this())]() { ServicePort::openAcceptor(thisPtr, serverPort); }));
+			g_scheduler.addEvent(createSchedulerTask("ServicePort::openAcceptor", 15000, [=, thisPtr = std::weak_ptr<ServicePort>(shared_from_this())]() { ServicePort::openAcceptor(thisPtr, serverPort); }));
 		}
 	}
 }
@@ -165,7 +206,7 @@ void ServicePort::open(uint16_t port)
 		std::cout << "[ServicePort::open] Error: " << e.what() << std::endl;
 
 		pendingStart = true;
-		g_scheduler.addEvent(createSchedulerTask(15000, [=, thisPtr = std::weak_ptr<ServicePort>(shared_from_this())]() { ServicePort::openAcceptor(thisPtr, serverPort); }));
+		g_scheduler.addEvent(createSchedulerTask("ServicePort::openAcceptor", 15000, [=, thisPtr = std::weak_ptr<ServicePort>(shared_from_this())]() { ServicePort::openAcceptor(thisPtr, serverPort); }));
 	}
 }
 
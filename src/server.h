@@ -11,6 +11,7 @@
 #include <gtl/phmap.hpp>
 
 class Protocol;
+class ServiceManager;
 
 class ServiceBase
 {
@@ -48,7 +49,7 @@ class Service final : public ServiceBase
 class ServicePort : public std::enable_shared_from_this<ServicePort>
 {
 	public:
-		explicit ServicePort(boost::asio::io_context& io_context) : io_context(io_context) {}
+		ServicePort(boost::asio::io_context& io_context, ServiceManager& manager) : io_context(io_context), manager(manager) {}
 		~ServicePort();
 
 		// non-copyable
@@ -71,6 +72,7 @@ class ServicePort : public std::enable_shared_from_this<ServicePort>
 		void accept();
 
 		boost::asio::io_context& io_context;
+		ServiceManager& manager;
 		std::unique_ptr<boost::asio::ip::tcp::acceptor> acceptor;
 		std::vector<Service_ptr> services;
 
@@ -98,12 +100,23 @@ class ServiceManager
 			return acceptors.empty() == false;
 		}
 
+		// the context the next accepted connection will live on, every
+		// connection stays on one context so its handlers never run concurrently
+		boost::asio::io_context& getNextIOContext();
+
 	private:
 		void die();
 
 		gtl::node_hash_map<uint16_t, ServicePort_ptr> acceptors;
 
 		boost::asio::io_context io_context;
+		// contexts run by networkThreads - 1 extra threads, the main context
+		// (acceptors, signals) takes its share of the connections too
+		std::vector<std::unique_ptr<boost::asio::io_context>> ioContexts;
+		std::vector<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>> ioWork;
+		std::vector<std::thread> ioThreads;
+		size_t nextIOContext = 0;
+		bool ioContextsCreated = false;
 		Signals signals{io_context};
 		boost::asio::steady_timer death_timer { io_context };
 		bool running = false;
@@ -122,7 +135,7 @@ bool ServiceManager::add(uint16_t port)
 	auto foundServicePort = acceptors.find(port);
 
 	if (foundServicePort == acceptors.end()) {
-		service_port = std::make_shared<ServicePort>(io_context);
+		service_port = std::make_shared<ServicePort>(io_context, *this);
 		service_port->open(port);
 		acceptors[port] = service_port;
 	} else {
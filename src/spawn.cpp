@@ -238,7 +238,7 @@ bool Spawns::isInZone(const Position& centerPos, int32_t radius, const Position&
 void Spawn::startSpawnCheck()
 {
 	if (checkSpawnEvent == 0) {
-		checkSpawnEvent = g_scheduler.addEvent(createSchedulerTask(getInterval(), [this]() { checkSpawn(); }));
+		checkSpawnEvent = g_scheduler.addEvent(createSchedulerTask("Spawn::checkSpawn", getInterval(), [this]() { checkSpawn(); }));
 	}
 }
 
@@ -369,7 +369,7 @@ void Spawn::checkSpawn()
 	}
 
 	if (spawnedMap.size() < spawnMap.size()) {
-		checkSpawnEvent = g_scheduler.addEvent(createSchedulerTask(getInterval(), [this]() { checkSpawn(); }));
+		checkSpawnEvent = g_scheduler.addEvent(createSchedulerTask("Spawn::checkSpawn", getInterval(), [this]() { checkSpawn(); }));
 	}
 }
 
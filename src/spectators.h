@@ -42,6 +42,7 @@ public:
 
 	size_t size() const { return vec.size(); }
 	bool empty() const { return vec.empty(); }
+	void clear() { vec.clear(); }
 	Iterator begin() { return vec.begin(); }
 	ConstIterator begin() const { return vec.begin(); }
 	Iterator end() { return vec.end(); }
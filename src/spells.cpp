@@ -465,8 +465,7 @@ bool Spell::playerInstantSpellCheck(const PlayerPtr& player, const Position& toP
 
 	auto tile = g_game.map.getTile(toPos);
 	if (!tile) {
-		tile = std::make_shared<Tile>(toPos.x, toPos.y, toPos.z);
-		g_game.map.setTile(toPos, tile);
+		tile = g_game.map.createVirtualTile(toPos);
 	}
 
 	if (blockingCreature && tile->getBottomVisibleCreature(player) != nullptr) {
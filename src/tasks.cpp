@@ -5,77 +5,206 @@
 
 #include "tasks.h"
 #include "game.h"
+#include "lockfree.h"
 
 extern Game g_game;
 
-Task* createTask(TaskFunc&& f)
+namespace {
+
+// blocks freed by a thread are kept in its own cache first, the dispatcher frees
+// nearly every task so its overflow goes to the shared list the network threads
+// allocate from
+constexpr size_t TASK_LOCAL_CACHE_SIZE = 1024;
+constexpr size_t TASK_SHARED_FREE_LIST_SIZE = 8192;
+
+using TaskFreeList = LockfreeFreeList<TASK_POOL_BLOCK_SIZE, TASK_SHARED_FREE_LIST_SIZE>;
+
+struct TaskLocalCache
+{
+	struct Block
+	{
+		Block* next;
+	};
+
+	~TaskLocalCache() {
+		while (void* p = pop()) {
+			if (!TaskFreeList::get().bounded_push(p)) {
+				::operator delete(p);
+			}
+		}
+		// tasks destroyed during static destruction bypass this cache
+		closed = true;
+	}
+
+	void* pop() {
+		Block* block = head;
+		if (block) {
+			head = block->next;
+			--size;
+		}
+		return block;
+	}
+
+	bool push(void* p) {
+		if (closed || size >= TASK_LOCAL_CACHE_SIZE) {
+			return false;
+		}
+
+		Block* block = static_cast<Block*>(p);
+		block->next = head;
+		head = block;
+		++size;
+		return true;
+	}
+
+	Block* head = nullptr;
+	size_t size = 0;
+	bool closed = false;
+};
+
+thread_local TaskLocalCache taskLocalCache;
+
+}
+
+void* Task::operator new(size_t size)
 {
-	return new Task(std::move(f));
+	if (size > TASK_POOL_BLOCK_SIZE) {
+		return ::operator new(size);
+	}
+
+	void* p = taskLocalCache.pop();
+	if (!p && !TaskFreeList::get().pop(p)) {
+		p = ::operator new(TASK_POOL_BLOCK_SIZE);
+	}
+	return p;
 }
 
-Task* createTask(uint32_t expiration, TaskFunc&& f)
+void Task::operator delete(void* p, size_t size)
 {
-	return new Task(expiration, std::move(f));
+	if (size > TASK_POOL_BLOCK_SIZE) {
+		::operator delete(p);
+		return;
+	}
+
+	if (!taskLocalCache.push(p) && !TaskFreeList::get().bounded_push(p)) {
+		::operator delete(p);
+	}
 }
 
 void Dispatcher::threadMain()
 {
-	std::vector<Task*> tmpTaskList;
-	// NOTE: second argument defer_lock is to prevent from immediate locking
-	std::unique_lock<std::mutex> taskLockUnique(taskLock, std::defer_lock);
-
 	while (getState() != THREAD_STATE_TERMINATED) {
-		// check if there are tasks waiting
-		taskLockUnique.lock();
-		if (taskList.empty()) {
-			//if the list is empty wait for signal
-			taskSignal.wait(taskLockUnique);
+		// take every task that is waiting in one go
+		Task* batch = taskHead.exchange(nullptr, std::memory_order_acquire);
+		if (!batch) {
+			//if the queue is empty wait until a producer pushes to it
+			taskHead.wait(nullptr, std::memory_order_acquire);
+			continue;
+		}
+
+		// the queue is a stack, reverse the batch to run the tasks in the order they were added
+		Task* task = nullptr;
+		while (batch) {
+			Task* next = batch->next;
+			batch->next = task;
+			task = batch;
+			batch = next;
 		}
-		tmpTaskList.swap(taskList);
-		taskLockUnique.unlock();
 
-		for (Task* task : tmpTaskList) {
+		auto nextFlush = std::chrono::steady_clock::now() + DISPATCHER_FLUSH_INTERVAL;
+		uint32_t tasksRun = 0;
+		while (task) {
+			Task* next = task->next;
 			if (!task->hasExpired()) {
 				++dispatcherCycle;
-				// execute it
-				(*task)();
+				runTask(task);
 			}
 			delete task;
+			task = next;
+
+			// a long batch must not hold back the packets of its first tasks
+			if (flushHook && ++tasksRun % DISPATCHER_FLUSH_CHECK_TASKS == 0) {
+				const auto now = std::chrono::steady_clock::now();
+				if (now >= nextFlush) {
+					flushHook();
+					nextFlush = now + DISPATCHER_FLUSH_INTERVAL;
+				}
+			}
+		}
+
+		if (flushHook) {
+			flushHook();
+		}
+
+		if (profiler.isEnabled()) {
+			profiler.dumpIfDue(DispatcherProfiler::now());
 		}
-		tmpTaskList.clear();
 	}
+
+	// release whatever was queued after the shutdown task, pairs with the fence in addTask
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	releaseQueuedTasks();
 }
 
-void Dispatcher::addTask(Task* task)
+void Dispatcher::releaseQueuedTasks()
 {
-	bool do_signal = false;
+	Task* task = taskHead.exchange(nullptr, std::memory_order_acquire);
+	while (task) {
+		Task* next = task->next;
+		delete task;
+		task = next;
+	}
+}
 
-	taskLock.lock();
+void Dispatcher::runTask(Task* task)
+{
+	if (!profiler.isEnabled()) {
+		// execute it
+		(*task)();
+		return;
+	}
+
+	const int64_t startedAt = DispatcherProfiler::now();
+	(*task)();
+	profiler.record(task->getTag(), task->queuedAt, startedAt, DispatcherProfiler::now());
+}
 
+void Dispatcher::pushTask(Task* task)
+{
+	Task* head = taskHead.load(std::memory_order_relaxed);
+	do {
+		task->next = head;
+	} while (!taskHead.compare_exchange_weak(head, task, std::memory_order_release, std::memory_order_relaxed));
+
+	// only wake the dispatcher if the queue was empty, otherwise it is already awake
+	if (!head) {
+		taskHead.notify_one();
+	}
+}
+
+void Dispatcher::addTask(Task* task)
+{
 	if (getState() == THREAD_STATE_RUNNING) {
-		do_signal = taskList.empty();
-		taskList.push_back(task);
+		if (profiler.isEnabled()) {
+			task->queuedAt = DispatcherProfiler::now();
+		}
+		pushTask(task);
+
+		// the dispatcher may have terminated between the state check and the push,
+		// its final drain could then have missed the task, so release it here
+		// (a closing dispatcher still runs its queue, only a terminated one stops)
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (getState() == THREAD_STATE_TERMINATED) {
+			releaseQueuedTasks();
+		}
 	} else {
 		delete task;
 	}
-
-	taskLock.unlock();
-
-	// send a signal if the list was empty
-	if (do_signal) {
-		taskSignal.notify_one();
-	}
 }
 
 void Dispatcher::shutdown()
 {
-	Task* task = createTask([this]() {
+	pushTask(createTask([this]() {
 		setState(THREAD_STATE_TERMINATED);
-		taskSignal.notify_one();
-	});
-
-	std::lock_guard<std::mutex> lockClass(taskLock);
-	taskList.push_back(task);
-
-	taskSignal.notify_one();
+	}));
 }
@@ -4,28 +4,59 @@
 #ifndef FS_TASKS_H
 #define FS_TASKS_H
 
-#include <condition_variable>
 #include "thread_holder_base.h"
+#include "dispatcherprofiler.h"
 #include "enums.h"
 
 using TaskFunc = std::function<void(void)>;
 const int DISPATCHER_TASK_EXPIRATION = 2000;
+// a batch that runs longer than this flushes in between its tasks, checked every
+// DISPATCHER_FLUSH_CHECK_TASKS tasks
+const std::chrono::milliseconds DISPATCHER_FLUSH_INTERVAL {10};
+const uint32_t DISPATCHER_FLUSH_CHECK_TASKS = 32;
 const auto SYSTEM_TIME_ZERO = std::chrono::system_clock::time_point(std::chrono::milliseconds(0));
 
+// callables up to this size (a few ids, a direction and a couple of positions)
+// are stored inside the task itself, bigger ones fall back to the heap
+static constexpr size_t TASK_INLINE_STORAGE = 64;
+// every Task and SchedulerTask is carved out of pooled blocks of this size
+static constexpr size_t TASK_POOL_BLOCK_SIZE = 128;
+
+template <typename F>
+concept TaskCallable = std::is_invocable_v<std::decay_t<F>&>;
+
 class Task
 {
 	public:
 		// DO NOT allocate this class on the stack
-		explicit Task(TaskFunc&& f) : func(std::move(f)) {}
-		Task(uint32_t ms, TaskFunc&& f) :
-			expiration(std::chrono::system_clock::now() + std::chrono::milliseconds(ms)), func(std::move(f)) {}
+		template <TaskCallable F>
+		explicit Task(F&& f) {
+			emplace(std::forward<F>(f));
+		}
+
+		template <TaskCallable F>
+		Task(uint32_t ms, F&& f) :
+			expiration(std::chrono::system_clock::now() + std::chrono::milliseconds(ms)) {
+			emplace(std::forward<F>(f));
+		}
+
+		virtual ~Task() {
+			destroy(storage);
+		}
+
+		// non-copyable
+		Task(const Task&) = delete;
+		Task& operator=(const Task&) = delete;
 
-		virtual ~Task() = default;
-		void operator()() const
+		void operator()()
 		{
-			func();
+			invoke(storage);
 		}
 
+		// tasks are recycled through per-thread and shared free lists instead of new/delete
+		static void* operator new(size_t size);
+		static void operator delete(void* p, size_t size);
+
 		void setDontExpire() {
 			expiration = SYSTEM_TIME_ZERO;
 		}
@@ -37,40 +68,118 @@ class Task
 			return expiration < std::chrono::system_clock::now();
 		}
 
+		// groups the task in the dispatcher profiler, must be a string literal
+		void setTag(const char* tag) {
+			this->tag = tag;
+		}
+
+		const char* getTag() const {
+			return tag;
+		}
+
 	protected:
 		std::chrono::system_clock::time_point expiration = SYSTEM_TIME_ZERO;
 
 	private:
+		template <typename F>
+		void emplace(F&& f) {
+			using Callable = std::decay_t<F>;
+			if constexpr (sizeof(Callable) <= TASK_INLINE_STORAGE && alignof(Callable) <= alignof(std::max_align_t)) {
+				new (storage) Callable(std::forward<F>(f));
+				invoke = [](void* p) { (*static_cast<Callable*>(p))(); };
+				destroy = [](void* p) { static_cast<Callable*>(p)->~Callable(); };
+			} else {
+				*reinterpret_cast<Callable**>(storage) = new Callable(std::forward<F>(f));
+				invoke = [](void* p) { (**static_cast<Callable**>(p))(); };
+				destroy = [](void* p) { delete *static_cast<Callable**>(p); };
+			}
+		}
+
 		// Expiration has another meaning for scheduler tasks,
 		// then it is the time the task should be added to the
 		// dispatcher
-		TaskFunc func;
+		alignas(std::max_align_t) unsigned char storage[TASK_INLINE_STORAGE];
+		void (*invoke)(void*) = nullptr;
+		void (*destroy)(void*) = nullptr;
+
+		// intrusive link used by the dispatcher queue
+		Task* next = nullptr;
+
+		const char* tag = nullptr;
+		// time the task entered the dispatcher queue, only set while profiling
+		int64_t queuedAt = 0;
+
+		friend class Dispatcher;
 };
 
-Task* createTask(TaskFunc&& f);
-Task* createTask(uint32_t expiration, TaskFunc&& f);
+template <TaskCallable F>
+Task* createTask(F&& f)
+{
+	return new Task(std::forward<F>(f));
+}
+
+template <TaskCallable F>
+Task* createTask(uint32_t expiration, F&& f)
+{
+	return new Task(expiration, std::forward<F>(f));
+}
+
+template <TaskCallable F>
+Task* createTask(const char* tag, F&& f)
+{
+	Task* task = new Task(std::forward<F>(f));
+	task->setTag(tag);
+	return task;
+}
+
+template <TaskCallable F>
+Task* createTask(const char* tag, uint32_t expiration, F&& f)
+{
+	Task* task = new Task(expiration, std::forward<F>(f));
+	task->setTag(tag);
+	return task;
+}
 
 class Dispatcher : public ThreadHolder<Dispatcher> {
 	public:
 		void addTask(Task* task);
 
-		void addTask(TaskFunc&& f) { addTask(new Task(std::move(f))); }
+		template <TaskCallable F>
+		void addTask(F&& f) { addTask(createTask(std::forward<F>(f))); }
 
-		void addTask(uint32_t expiration, TaskFunc&& f) { addTask(new Task(expiration, std::move(f))); }
+		template <TaskCallable F>
+		void addTask(uint32_t expiration, F&& f) { addTask(createTask(expiration, std::forward<F>(f))); }
 
 		void shutdown();
 
+		// called on the dispatcher thread whenever it finishes a batch of tasks,
+		// must be set before the thread is started
+		void setFlushHook(TaskFunc hook) {
+			flushHook = std::move(hook);
+		}
+
 		uint64_t getDispatcherCycle() const {
 			return dispatcherCycle;
 		}
 
+		DispatcherProfiler& getProfiler() {
+			return profiler;
+		}
+
 		void threadMain();
 
 	private:
-		std::mutex taskLock;
-		std::condition_variable taskSignal;
+		void pushTask(Task* task);
+		void runTask(Task* task);
+		void releaseQueuedTasks();
+
+		// multi-producer/single-consumer queue: producers push onto this
+		// lock-free stack and the dispatcher thread takes the whole batch at once,
+		// sleeping on the atomic (a futex on Linux) while it is empty
+		std::atomic<Task*> taskHead{nullptr};
 
-		std::vector<Task*> taskList;
+		DispatcherProfiler profiler;
+		TaskFunc flushHook;
 		uint64_t dispatcherCycle = 0;
 };
 
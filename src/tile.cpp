@@ -358,12 +358,6 @@ void Tile::onAddTileItem(ItemPtr& item)
 		}
 	}
 
-	//event methods
-	for (const auto spectator : spectators) {
-		TilePtr tp = this->getTile();
-		spectator->onAddTileItem(tp, cylinderMapPos);
-	}
-
 	if ((!hasFlag(TILESTATE_PROTECTIONZONE) || g_config.getBoolean(ConfigManager::CLEAN_PROTECTION_ZONES)) && item->isCleanable()) {
 		if (!isHouseTile()) {
 			g_game.addTileToClean(getTile());
@@ -402,7 +396,9 @@ void Tile::onUpdateTileItem(const ItemPtr& oldItem, const ItemType& oldType, con
 
 	//event methods
 	for (const auto spectator : spectators) {
-		spectator->onUpdateTileItem(getTile(), cylinderMapPos, oldItem, oldType, newItem, newType);
+		if (const auto spectatorPlayer = spectator->getPlayer()) {
+			spectatorPlayer->onUpdateTileItem(getTile(), cylinderMapPos, oldItem, oldType, newItem, newType);
+		}
 	}
 }
 
@@ -429,7 +425,9 @@ void Tile::onRemoveTileItem(const SpectatorVec& spectators, const std::vector<in
 
 	//event methods
 	for (const auto spectator : spectators) {
-		spectator->onRemoveTileItem(getTile(), cylinderMapPos, iType, item);
+		if (const auto tmpPlayer = spectator->getPlayer()) {
+			tmpPlayer->onRemoveTileItem(getTile(), cylinderMapPos, iType, item);
+		}
 	}
 
 	if (!hasFlag(TILESTATE_PROTECTIONZONE) || g_config.getBoolean(ConfigManager::CLEAN_PROTECTION_ZONES)) {
@@ -657,6 +655,38 @@ ReturnValue Tile::queryAdd(MonsterPtr monster, uint32_t flags) {
 }
 
 
+bool Tile::isPassableFor(const uint8_t movementClass) const
+{
+	// the generic queryAdd already refuses any creature on a blocking tile
+	if (!ground || hasFlag(TILESTATE_FLOORCHANGE | TILESTATE_TELEPORT | TILESTATE_PROTECTIONZONE | TILESTATE_BLOCKSOLID)) {
+		return false;
+	}
+
+	if (isHouseTile() || hasFlag(TILESTATE_IMMOVABLEBLOCKSOLID | TILESTATE_IMMOVABLENOFIELDBLOCKPATH)) {
+		return false;
+	}
+
+	if (hasFlag(TILESTATE_NOFIELDBLOCKPATH) && !hasBitSet(MOVEMENTCLASS_PUSHITEMS, movementClass)) {
+		return false;
+	}
+
+	const auto field = getFieldItem();
+	if (!field || field->isBlocking() || field->getDamage() == 0) {
+		return true;
+	}
+
+	switch (field->getCombatType()) {
+		case COMBAT_FIREDAMAGE:
+			return hasBitSet(MOVEMENTCLASS_FIRE, movementClass);
+		case COMBAT_ENERGYDAMAGE:
+			return hasBitSet(MOVEMENTCLASS_ENERGY, movementClass);
+		case COMBAT_EARTHDAMAGE:
+			return hasBitSet(MOVEMENTCLASS_POISON, movementClass);
+		default:
+			return true;
+	}
+}
+
 ReturnValue Tile::queryAdd(NpcPtr npc, uint32_t flags) {
 	if (npc->isPhaseable()) {
 		return RETURNVALUE_NOERROR;
@@ -921,9 +951,8 @@ void Tile::addThing(ThingPtr thing)
 void Tile::addThing(int32_t, ThingPtr thing)
 {
 	if (const auto& creature = thing->getCreature()) {
-		g_game.map.clearChunkSpectatorCache();
 		creature->setParent(getTile());
-		const auto& creatures = getCreatures();
+		const auto& creatures = makeCreatures();
 		creatures->insert(creatures->begin(), creature);
 	} else {
 		auto item = thing->getItem();
@@ -975,17 +1004,14 @@ void Tile::addThing(int32_t, ThingPtr thing)
 
 			bool isInserted = false;
 
-			if (items) {
-				for (auto it = items->getBeginTopItem(), end = items->getEndTopItem(); it != end; ++it) {
-					//Note: this is different from internalAddThing
-					if (itemType.alwaysOnTopOrder <= Item::items[(*it)->getID()].alwaysOnTopOrder) {
-						items->insert(it, item);
-						isInserted = true;
-						break;
-					}
+			items = makeItemList();
+			for (auto it = items->getBeginTopItem(), end = items->getEndTopItem(); it != end; ++it) {
+				//Note: this is different from internalAddThing
+				if (itemType.alwaysOnTopOrder <= Item::items[(*it)->getID()].alwaysOnTopOrder) {
+					items->insert(it, item);
+					isInserted = true;
+					break;
 				}
-			} else {
-				// std::unreachable()
 			}
 
 			if (!isInserted) {
@@ -1014,6 +1040,7 @@ void Tile::addThing(int32_t, ThingPtr thing)
 				}
 			}
 
+			items = makeItemList();
 			items->insert(items->getBeginDownItem(), item);
 			items->addDownItemCount(1);
 			onAddTileItem(item);
@@ -1118,8 +1145,6 @@ void Tile::removeThing(ThingPtr thing, uint32_t count)
 	if (const auto creature = thing->getCreature()) {
 		if (const auto creatures = getCreatures()) {
 			if (const auto it = std::ranges::find(*creatures, thing); it != creatures->end()) {
-				g_game.map.clearChunkSpectatorCache();
-
 				creatures->erase(it);
 			}
 		}
@@ -1472,9 +1497,7 @@ void Tile::internalAddThing(uint32_t, ThingPtr thing)
 	thing->setParent(getTile());
 
 	if (const auto& creature = thing->getCreature()) {
-		g_game.map.clearChunkSpectatorCache();
-
-		const auto& creatures = getCreatures();
+		const auto& creatures = makeCreatures();
 		creatures->insert(creatures->begin(), creature);
 	} else {
 		const auto& item = thing->getItem();
@@ -1491,7 +1514,7 @@ void Tile::internalAddThing(uint32_t, ThingPtr thing)
 			return;
 		}
 
-		auto items = getItemList();
+		auto items = makeItemList();
 		if (items->size() >= 0xFFFF) {
 			return /*RETURNVALUE_NOTPOSSIBLE*/;
 		}
@@ -1520,6 +1543,8 @@ void Tile::internalAddThing(uint32_t, ThingPtr thing)
 
 void Tile::setTileFlags(const ItemConstPtr& item)
 {
+	const uint32_t oldFlags = flags;
+
 	if (!hasFlag(TILESTATE_FLOORCHANGE)) {
 		if (const ItemType& it = Item::items[item->getID()]; it.floorChange != 0) {
 			setFlag(it.floorChange);
@@ -1562,6 +1587,10 @@ void Tile::setTileFlags(const ItemConstPtr& item)
 		setFlag(TILESTATE_BLOCKSOLID);
 	}
 
+	if (item->hasProperty(CONST_PROP_BLOCKPROJECTILE)) {
+		setFlag(TILESTATE_BLOCKPROJECTILE);
+	}
+
 	if (item->getBed()) {
 		setFlag(TILESTATE_BED);
 	}
@@ -1574,10 +1603,14 @@ void Tile::setTileFlags(const ItemConstPtr& item)
 	if (item->hasProperty(CONST_PROP_SUPPORTHANGABLE)) {
 		setFlag(TILESTATE_SUPPORTS_HANGABLE);
 	}
+
+	checkPathingChange(item, oldFlags);
 }
 
 void Tile::resetTileFlags(const ItemPtr& item)
 {
+	const uint32_t oldFlags = flags;
+
 	if (const ItemType& it = Item::items[item->getID()]; it.floorChange != 0) {
 		resetFlag(TILESTATE_FLOORCHANGE);
 	}
@@ -1586,6 +1619,10 @@ void Tile::resetTileFlags(const ItemPtr& item)
 		resetFlag(TILESTATE_BLOCKSOLID);
 	}
 
+	if (item->hasProperty(CONST_PROP_BLOCKPROJECTILE) && !hasProperty(item, CONST_PROP_BLOCKPROJECTILE)) {
+		resetFlag(TILESTATE_BLOCKPROJECTILE);
+	}
+
 	if (item->hasProperty(CONST_PROP_IMMOVABLEBLOCKSOLID) && !hasProperty(item, CONST_PROP_IMMOVABLEBLOCKSOLID)) {
 		resetFlag(TILESTATE_IMMOVABLEBLOCKSOLID);
 	}
@@ -1633,6 +1670,29 @@ void Tile::resetTileFlags(const ItemPtr& item)
 	if (item->hasProperty(CONST_PROP_SUPPORTHANGABLE)) {
 		resetFlag(TILESTATE_SUPPORTS_HANGABLE);
 	}
+
+	checkPathingChange(item, oldFlags);
+}
+
+void Tile::checkPathingChange(const ItemConstPtr& item, const uint32_t oldFlags) const
+{
+	static constexpr uint32_t pathingFlags = TILESTATE_FLOORCHANGE | TILESTATE_TELEPORT | TILESTATE_MAGICFIELD |
+		TILESTATE_BLOCKSOLID | TILESTATE_BLOCKPATH | TILESTATE_NOFIELDBLOCKPATH |
+		TILESTATE_IMMOVABLEBLOCKSOLID | TILESTATE_IMMOVABLEBLOCKPATH | TILESTATE_IMMOVABLENOFIELDBLOCKPATH;
+
+	if (((oldFlags ^ flags) & pathingFlags) != 0 || item->isGroundTile()) {
+		g_game.map.onTilePathingChange(tilePos);
+	}
+
+	// sight lines over upper floors are blocked by ground as well
+	if (((oldFlags ^ flags) & TILESTATE_BLOCKPROJECTILE) != 0 || item->isGroundTile()) {
+		g_game.map.onTileSightChange(tilePos);
+	}
+}
+
+const ZoneSet& Tile::getZones() const
+{
+	return Zones::getZoneSet(zoneSetId);
 }
 
 bool Tile::isMoveableBlocking() const
@@ -9,6 +9,7 @@
 #include "tools.h"
 #include "spectators.h"
 #include "declarations.h"
+#include "zones.h"
 
 enum tileflags_t : uint32_t {
 	TILESTATE_NONE = 0,
@@ -37,10 +38,23 @@ enum tileflags_t : uint32_t {
 	TILESTATE_IMMOVABLENOFIELDBLOCKPATH = 1 << 21,
 	TILESTATE_NOFIELDBLOCKPATH = 1 << 22,
 	TILESTATE_SUPPORTS_HANGABLE = 1 << 23,
+	TILESTATE_BLOCKPROJECTILE = 1 << 24,
 
 	TILESTATE_FLOORCHANGE = TILESTATE_FLOORCHANGE_DOWN | TILESTATE_FLOORCHANGE_NORTH | TILESTATE_FLOORCHANGE_SOUTH | TILESTATE_FLOORCHANGE_EAST | TILESTATE_FLOORCHANGE_WEST | TILESTATE_FLOORCHANGE_SOUTH_ALT | TILESTATE_FLOORCHANGE_EAST_ALT,
 };
 
+// What apart from other creatures decides which tiles a monster can walk on, monsters
+// alike in these share one passability layer per map floor
+enum MovementClass_t : uint8_t {
+	MOVEMENTCLASS_NONE = 0,
+	MOVEMENTCLASS_PUSHITEMS = 1 << 0,
+	MOVEMENTCLASS_FIRE = 1 << 1,
+	MOVEMENTCLASS_ENERGY = 1 << 2,
+	MOVEMENTCLASS_POISON = 1 << 3,
+
+	MOVEMENTCLASS_COUNT = 1 << 4,
+};
+
 enum ZoneType_t {
 	ZONE_PROTECTION,
 	ZONE_NOPVP,
@@ -136,14 +150,10 @@ class House;
 class Tile : public Cylinder, public SharedObject
 {
 	public:
-		Tile(uint16_t x, uint16_t y, uint8_t z) : tilePos(x, y, z) {
-			items = std::make_shared<TileItemVector>();
-			creatures = std::make_shared<CreatureVector>();
-		}
+		// the item and creature lists are only allocated once something is put on the tile
+		Tile(uint16_t x, uint16_t y, uint8_t z) : tilePos(x, y, z) {}
 
 		Tile(uint16_t x, uint16_t y, uint8_t z, House* house) : tilePos(x, y, z) {
-			items = std::make_shared<TileItemVector>();
-			creatures = std::make_shared<CreatureVector>();
 			this->house = house;
 		}
 
@@ -225,6 +235,15 @@ class Tile : public Cylinder, public SharedObject
 			return this->flags;
 		}
 
+		// the zones the tile is in, kept up to date by Zones when they are loaded
+		const ZoneSet& getZones() const;
+		uint16_t getZoneSetId() const {
+			return zoneSetId;
+		}
+		void setZoneSetId(uint16_t id) {
+			zoneSetId = id;
+		}
+
 		void setFlag(uint32_t flag) {
 			this->flags |= flag;
 		}
@@ -266,6 +285,8 @@ class Tile : public Cylinder, public SharedObject
 		ReturnValue queryAdd(ItemPtr item, uint32_t flags, CreaturePtr mover);
 		ReturnValue queryAdd(PlayerPtr player, uint32_t flags);
 		ReturnValue queryAdd(MonsterPtr monster, uint32_t flags);
+		// queryAdd for a monster of that movement class searching a path, without the creatures on the tile
+		bool isPassableFor(uint8_t movementClass) const;
 		ReturnValue queryAdd(NpcPtr npc, uint32_t flags);
 
 		void addThing(ThingPtr thing) override final;
@@ -298,7 +319,7 @@ class Tile : public Cylinder, public SharedObject
 			return false;
 		}
 
-		bool isHouseTile() {
+		bool isHouseTile() const {
 			return house != nullptr;
 		}
 
@@ -323,16 +344,32 @@ class Tile : public Cylinder, public SharedObject
 		void updateHouse(const ItemPtr& item);
 
 	private:
+		TileItemsPtr makeItemList() {
+			if (!items) {
+				items = std::make_shared<TileItemVector>();
+			}
+			return items;
+		}
+
+		TileCreaturesPtr makeCreatures() {
+			if (!creatures) {
+				creatures = std::make_shared<CreatureVector>();
+			}
+			return creatures;
+		}
+
 		void onAddTileItem(ItemPtr& item);
 		void onUpdateTileItem(const ItemPtr& oldItem, const ItemType& oldType, const ItemPtr& newItem, const ItemType& newType);
 		void onRemoveTileItem(const SpectatorVec& spectators, const std::vector<int32_t>& oldStackPosVector, const ItemPtr& item);
 		void onUpdateTile(const SpectatorVec& spectators);
 		void setTileFlags(const ItemConstPtr& item);
 		void resetTileFlags(const ItemPtr& item);
+		void checkPathingChange(const ItemConstPtr& item, uint32_t oldFlags) const;
 
 		House* house = nullptr;
 		ItemPtr ground = nullptr;
 		Position tilePos;
+		uint16_t zoneSetId = 0; // fits in the padding after tilePos
 		uint32_t flags = 0;
 		TileItemsPtr items;
 		TileCreaturesPtr creatures;
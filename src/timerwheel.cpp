@@ -0,0 +1,141 @@
+// Copyright 2024 Black Tek Server Authors. All rights reserved.
+// Use of this source code is governed by the GPL-2.0 License that can be found in the LICENSE file.
+
+#include "otpch.h"
+
+#include "timerwheel.h"
+#include "scheduler.h"
+
+TimerWheel::~TimerWheel()
+{
+	clear();
+}
+
+void TimerWheel::reset(uint64_t tick)
+{
+	assert(index.empty());
+	currentTick = tick;
+}
+
+void TimerWheel::insert(SchedulerTask* task, uint64_t expireTick)
+{
+	// a task is never due before the next tick
+	if (expireTick <= currentTick) {
+		expireTick = currentTick + 1;
+	}
+
+	TimerNode* node = allocateNode();
+	node->task = task;
+	node->expireTick = expireTick;
+	node->eventId = task->getEventId();
+	link(node);
+
+	index[node->eventId] = node;
+}
+
+bool TimerWheel::cancel(uint32_t eventId)
+{
+	auto it = index.find(eventId);
+	if (it == index.end()) {
+		return false;
+	}
+
+	TimerNode* node = it->second;
+	index.erase(it);
+
+	unlink(node);
+	delete node->task;
+	releaseNode(node);
+	return true;
+}
+
+void TimerWheel::clear()
+{
+	for (auto& it : index) {
+		TimerNode* node = it.second;
+		unlink(node);
+		delete node->task;
+		releaseNode(node);
+	}
+	index.clear();
+}
+
+TimerWheel::TimerNode* TimerWheel::allocateNode()
+{
+	if (!freeNodes) {
+		// nodes are handed out from chunks so thousands of pending events don't mean thousands of allocations
+		nodeChunks.emplace_back(std::make_unique<TimerNode[]>(NODE_CHUNK_SIZE));
+		TimerNode* chunk = nodeChunks.back().get();
+		for (size_t i = 0; i < NODE_CHUNK_SIZE; ++i) {
+			chunk[i].next = freeNodes;
+			freeNodes = &chunk[i];
+		}
+	}
+
+	TimerNode* node = freeNodes;
+	freeNodes = node->next;
+	node->next = nullptr;
+	return node;
+}
+
+void TimerWheel::releaseNode(TimerNode* node)
+{
+	node->task = nullptr;
+	node->slot = nullptr;
+	node->prev = nullptr;
+	node->next = freeNodes;
+	freeNodes = node;
+}
+
+TimerWheel::TimerSlot* TimerWheel::slotFor(uint64_t expireTick)
+{
+	const uint64_t delta = expireTick - currentTick;
+	uint32_t level = 0;
+	while (level < LEVELS - 1 && delta >= (uint64_t{1} << ((level + 1) * SLOT_BITS))) {
+		++level;
+	}
+	return &slots[level][(expireTick >> (level * SLOT_BITS)) & SLOT_MASK];
+}
+
+void TimerWheel::link(TimerNode* node)
+{
+	TimerSlot* slot = slotFor(node->expireTick);
+	node->slot = slot;
+	node->prev = nullptr;
+	node->next = slot->head;
+	if (slot->head) {
+		slot->head->prev = node;
+	}
+	slot->head = node;
+}
+
+void TimerWheel::unlink(TimerNode* node)
+{
+	if (node->prev) {
+		node->prev->next = node->next;
+	} else {
+		node->slot->head = node->next;
+	}
+
+	if (node->next) {
+		node->next->prev = node->prev;
+	}
+
+	node->slot = nullptr;
+	node->prev = nullptr;
+	node->next = nullptr;
+}
+
+void TimerWheel::cascade(uint32_t level)
+{
+	TimerSlot& slot = slots[level][(currentTick >> (level * SLOT_BITS)) & SLOT_MASK];
+	TimerNode* node = slot.head;
+	slot.head = nullptr;
+
+	// every node of an upper level slot moves at least one level down
+	while (node) {
+		TimerNode* next = node->next;
+		link(node);
+		node = next;
+	}
+}
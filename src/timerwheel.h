@@ -0,0 +1,126 @@
+// Copyright 2024 Black Tek Server Authors. All rights reserved.
+// Use of this source code is governed by the GPL-2.0 License that can be found in the LICENSE file.
+
+#ifndef FS_TIMERWHEEL_H
+#define FS_TIMERWHEEL_H
+
+#include <gtl/phmap.hpp>
+
+class SchedulerTask;
+
+// Hierarchical timing wheel with a resolution of one tick (1 ms in the scheduler).
+// Four levels of 256 slots cover the whole uint32_t delay range, inserting and
+// cancelling are O(1) and every slot that expires is handed out as one batch.
+// The wheel is not thread safe, it is only ever touched from the scheduler thread.
+class TimerWheel
+{
+	public:
+		static constexpr uint32_t LEVELS = 4;
+		static constexpr uint32_t SLOT_BITS = 8;
+		static constexpr uint32_t SLOTS = 1 << SLOT_BITS;
+		static constexpr uint32_t SLOT_MASK = SLOTS - 1;
+
+		TimerWheel() = default;
+		~TimerWheel();
+
+		// non-copyable
+		TimerWheel(const TimerWheel&) = delete;
+		TimerWheel& operator=(const TimerWheel&) = delete;
+
+		// the wheel is empty until the first insert, so it can be re-based on an idle scheduler
+		void reset(uint64_t tick);
+
+		void insert(SchedulerTask* task, uint64_t expireTick);
+		bool cancel(uint32_t eventId);
+
+		// advances the wheel up to (and including) tick, calling expired for every due task
+		template <typename Callback>
+		void advance(uint64_t tick, Callback&& expired);
+
+		// deletes every pending task, used when the scheduler shuts down
+		void clear();
+
+		bool empty() const {
+			return index.empty();
+		}
+
+		size_t size() const {
+			return index.size();
+		}
+
+		uint64_t getCurrentTick() const {
+			return currentTick;
+		}
+
+	private:
+		struct TimerSlot;
+
+		struct TimerNode
+		{
+			SchedulerTask* task = nullptr;
+			TimerSlot* slot = nullptr;
+			TimerNode* prev = nullptr;
+			TimerNode* next = nullptr;
+			uint64_t expireTick = 0;
+			uint32_t eventId = 0;
+		};
+
+		struct TimerSlot
+		{
+			TimerNode* head = nullptr;
+		};
+
+		static constexpr size_t NODE_CHUNK_SIZE = 1024;
+
+		TimerNode* allocateNode();
+		void releaseNode(TimerNode* node);
+
+		void link(TimerNode* node);
+		void unlink(TimerNode* node);
+		void cascade(uint32_t level);
+
+		TimerSlot* slotFor(uint64_t expireTick);
+
+		TimerSlot slots[LEVELS][SLOTS] = {};
+		gtl::flat_hash_map<uint32_t, TimerNode*> index;
+
+		std::vector<std::unique_ptr<TimerNode[]>> nodeChunks;
+		TimerNode* freeNodes = nullptr;
+
+		uint64_t currentTick = 0;
+};
+
+template <typename Callback>
+void TimerWheel::advance(uint64_t tick, Callback&& expired)
+{
+	while (currentTick < tick) {
+		if (index.empty()) {
+			// nothing left to expire, jump straight to the target tick
+			currentTick = tick;
+			return;
+		}
+
+		++currentTick;
+
+		// cascade the upper levels whenever the lower level wraps around
+		for (uint32_t level = 1; level < LEVELS; ++level) {
+			if (((currentTick >> ((level - 1) * SLOT_BITS)) & SLOT_MASK) != 0) {
+				break;
+			}
+			cascade(level);
+		}
+
+		TimerSlot& slot = slots[0][currentTick & SLOT_MASK];
+		while (TimerNode* node = slot.head) {
+			unlink(node);
+
+			SchedulerTask* task = node->task;
+			index.erase(node->eventId);
+			releaseNode(node);
+
+			expired(task);
+		}
+	}
+}
+
+#endif
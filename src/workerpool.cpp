@@ -0,0 +1,111 @@
+// Copyright 2024 Black Tek Server Authors. All rights reserved.
+// Use of this source code is governed by the GPL-2.0 License that can be found in the LICENSE file.
+
+#include "otpch.h"
+
+#include "workerpool.h"
+
+WorkerPool::~WorkerPool()
+{
+	shutdown();
+}
+
+void WorkerPool::start(size_t threadCount)
+{
+	if (isRunning()) {
+		return;
+	}
+
+	if (threadCount == 0) {
+		threadCount = std::max<size_t>(1, std::thread::hardware_concurrency()) - 1;
+	}
+
+	stopping = false;
+	threads.reserve(threadCount);
+	for (size_t i = 0; i < threadCount; ++i) {
+		threads.emplace_back(&WorkerPool::threadMain, this);
+	}
+}
+
+void WorkerPool::shutdown()
+{
+	{
+		std::lock_guard<std::mutex> lockGuard(mutex);
+		stopping = true;
+	}
+	jobSignal.notify_all();
+
+	for (std::thread& thread : threads) {
+		if (thread.joinable()) {
+			thread.join();
+		}
+	}
+	threads.clear();
+}
+
+void WorkerPool::parallelFor(size_t count, const std::function<void(size_t)>& function)
+{
+	if (count == 0) {
+		return;
+	}
+
+	if (threads.empty() || count == 1) {
+		for (size_t i = 0; i < count; ++i) {
+			function(i);
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lockGuard(mutex);
+		job = &function;
+		jobSize = count;
+		nextIndex.store(0, std::memory_order_relaxed);
+		++generation;
+	}
+	jobSignal.notify_all();
+
+	runJob(function);
+
+	// workers that picked the job up still hold a reference to it
+	std::unique_lock<std::mutex> jobLock(mutex);
+	job = nullptr;
+	doneSignal.wait(jobLock, [this]() { return busyWorkers == 0; });
+}
+
+void WorkerPool::runJob(const std::function<void(size_t)>& function)
+{
+	for (size_t i = nextIndex.fetch_add(1, std::memory_order_relaxed); i < jobSize; i = nextIndex.fetch_add(1, std::memory_order_relaxed)) {
+		function(i);
+	}
+}
+
+void WorkerPool::threadMain()
+{
+	uint64_t seenGeneration = 0;
+
+	std::unique_lock<std::mutex> jobLock(mutex);
+	while (true) {
+		jobSignal.wait(jobLock, [&]() { return stopping || generation != seenGeneration; });
+		if (stopping) {
+			break;
+		}
+
+		seenGeneration = generation;
+		if (!job) {
+			// woke up after the caller already finished the job alone
+			continue;
+		}
+
+		const std::function<void(size_t)>& function = *job;
+		++busyWorkers;
+		jobLock.unlock();
+
+		runJob(function);
+
+		jobLock.lock();
+		if (--busyWorkers == 0) {
+			doneSignal.notify_one();
+		}
+	}
+}
@@ -0,0 +1,58 @@
+// Copyright 2024 Black Tek Server Authors. All rights reserved.
+// Use of this source code is governed by the GPL-2.0 License that can be found in the LICENSE file.
+
+#ifndef FS_WORKERPOOL_H
+#define FS_WORKERPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// Fork-join pool for read-only work the dispatcher wants to spread over several cores.
+// parallelFor blocks the calling thread, which takes part in the work, until every
+// index has been processed, so the game state can not change while the workers run.
+class WorkerPool
+{
+	public:
+		WorkerPool() = default;
+		~WorkerPool();
+
+		// non-copyable
+		WorkerPool(const WorkerPool&) = delete;
+		WorkerPool& operator=(const WorkerPool&) = delete;
+
+		// threads = 0 uses one worker less than the hardware has, the caller is the last one
+		void start(size_t threads);
+		void shutdown();
+
+		bool isRunning() const {
+			return !threads.empty();
+		}
+
+		size_t getThreadCount() const {
+			return threads.size();
+		}
+
+		void parallelFor(size_t count, const std::function<void(size_t)>& function);
+
+	private:
+		void threadMain();
+		void runJob(const std::function<void(size_t)>& function);
+
+		std::vector<std::thread> threads;
+
+		std::mutex mutex;
+		std::condition_variable jobSignal;
+		std::condition_variable doneSignal;
+
+		const std::function<void(size_t)>* job = nullptr;
+		size_t jobSize = 0;
+		std::atomic<size_t> nextIndex{0};
+		uint64_t generation = 0;
+		uint32_t busyWorkers = 0;
+		bool stopping = false;
+};
+
+#endif
@@ -8,8 +8,105 @@
 #include <array>
 #include <assert.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define XTEA_SSE2
+#endif
+
 namespace xtea {
 
+namespace {
+
+#ifdef XTEA_SSE2
+
+// Blocks are independent of each other, four of them go through all rounds together with
+// their left halves in one register and their right halves in another. Two such groups are
+// interleaved so that one can run while the other waits on its previous round.
+constexpr size_t VECTOR_BLOCKS = 8;
+constexpr size_t VECTOR_BYTES = VECTOR_BLOCKS * 8;
+
+constexpr size_t ROUND_KEYS = std::tuple_size_v<round_keys>;
+
+// a plain array, std::array would drop the vector type's alignment attribute
+struct vector_keys
+{
+	alignas(16) __m128i k[ROUND_KEYS];
+};
+
+vector_keys broadcast_keys(const round_keys& k)
+{
+	vector_keys broadcast;
+	for (size_t i = 0; i < ROUND_KEYS; ++i) {
+		broadcast.k[i] = _mm_set1_epi32(static_cast<int32_t>(k[i]));
+	}
+	return broadcast;
+}
+
+// four blocks
+inline void load_blocks(const uint8_t* data, __m128i& left, __m128i& right)
+{
+	const __m128i first = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), _MM_SHUFFLE(3, 1, 2, 0));
+	const __m128i second = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16)), _MM_SHUFFLE(3, 1, 2, 0));
+	left = _mm_unpacklo_epi64(first, second);
+	right = _mm_unpackhi_epi64(first, second);
+}
+
+inline void store_blocks(uint8_t* data, const __m128i left, const __m128i right)
+{
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(data), _mm_unpacklo_epi32(left, right));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(data + 16), _mm_unpackhi_epi32(left, right));
+}
+
+// (v << 4 ^ v >> 5) + v
+inline __m128i mix(const __m128i v)
+{
+	return _mm_add_epi32(_mm_xor_si128(_mm_slli_epi32(v, 4), _mm_srli_epi32(v, 5)), v);
+}
+
+void encrypt_vector(uint8_t* data, const size_t length, const vector_keys& keys)
+{
+	const __m128i* k = keys.k;
+	for (auto it = data, last = data + length; it < last; it += VECTOR_BYTES) {
+		__m128i left[2], right[2];
+		load_blocks(it, left[0], right[0]);
+		load_blocks(it + 32, left[1], right[1]);
+
+		for (size_t i = 0; i < ROUND_KEYS; i += 2) {
+			left[0] = _mm_add_epi32(left[0], _mm_xor_si128(mix(right[0]), k[i]));
+			left[1] = _mm_add_epi32(left[1], _mm_xor_si128(mix(right[1]), k[i]));
+			right[0] = _mm_add_epi32(right[0], _mm_xor_si128(mix(left[0]), k[i + 1]));
+			right[1] = _mm_add_epi32(right[1], _mm_xor_si128(mix(left[1]), k[i + 1]));
+		}
+
+		store_blocks(it, left[0], right[0]);
+		store_blocks(it + 32, left[1], right[1]);
+	}
+}
+
+void decrypt_vector(uint8_t* data, const size_t length, const vector_keys& keys)
+{
+	const __m128i* k = keys.k;
+	for (auto it = data, last = data + length; it < last; it += VECTOR_BYTES) {
+		__m128i left[2], right[2];
+		load_blocks(it, left[0], right[0]);
+		load_blocks(it + 32, left[1], right[1]);
+
+		for (size_t i = ROUND_KEYS; i > 0; i -= 2) {
+			right[0] = _mm_sub_epi32(right[0], _mm_xor_si128(mix(left[0]), k[i - 1]));
+			right[1] = _mm_sub_epi32(right[1], _mm_xor_si128(mix(left[1]), k[i - 1]));
+			left[0] = _mm_sub_epi32(left[0], _mm_xor_si128(mix(right[0]), k[i - 2]));
+			left[1] = _mm_sub_epi32(left[1], _mm_xor_si128(mix(right[1]), k[i - 2]));
+		}
+
+		store_blocks(it, left[0], right[0]);
+		store_blocks(it + 32, left[1], right[1]);
+	}
+}
+
+#endif
+
+}
+
 round_keys expand_key(const key& k)
 {
 	constexpr uint32_t delta = 0x9E3779B9;
@@ -25,7 +122,33 @@ round_keys expand_key(const key& k)
 
 void encrypt(uint8_t* data, size_t length, const round_keys& k)
 {
-	for (int32_t i = 0; i < k.size(); i += 2) {
+#ifdef XTEA_SSE2
+	if (const size_t vectorLength = length - length % VECTOR_BYTES; vectorLength != 0) {
+		encrypt_vector(data, vectorLength, broadcast_keys(k));
+		data += vectorLength;
+		length -= vectorLength;
+	}
+#endif
+
+	encrypt_reference(data, length, k);
+}
+
+void decrypt(uint8_t* data, size_t length, const round_keys& k)
+{
+#ifdef XTEA_SSE2
+	if (const size_t vectorLength = length - length % VECTOR_BYTES; vectorLength != 0) {
+		decrypt_vector(data, vectorLength, broadcast_keys(k));
+		data += vectorLength;
+		length -= vectorLength;
+	}
+#endif
+
+	decrypt_reference(data, length, k);
+}
+
+void encrypt_reference(uint8_t* data, size_t length, const round_keys& k)
+{
+	for (size_t i = 0; i < k.size(); i += 2) {
 		for (auto it = data, last = data + length; it < last; it += 8) {
 			uint32_t left, right;
 			std::memcpy(&left, it, 4);
@@ -40,7 +163,7 @@ void encrypt(uint8_t* data, size_t length, const round_keys& k)
 	}
 }
 
-void decrypt(uint8_t* data, size_t length, const round_keys& k)
+void decrypt_reference(uint8_t* data, size_t length, const round_keys& k)
 {
 	for (int32_t i = k.size() - 1; i > 0; i -= 2) {
 		for (auto it = data, last = data + length; it < last; it += 8) {
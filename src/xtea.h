@@ -13,6 +13,11 @@ round_keys expand_key(const key& k);
 void encrypt(uint8_t* data, size_t length, const round_keys& k);
 void decrypt(uint8_t* data, size_t length, const round_keys& k);
 
+// one block at a time, encrypt and decrypt run several blocks at once where the CPU can
+// and have to give the same bytes as these
+void encrypt_reference(uint8_t* data, size_t length, const round_keys& k);
+void decrypt_reference(uint8_t* data, size_t length, const round_keys& k);
+
 } // namespace xtea
 
 #endif // TFS_XTEA_H
@@ -3,13 +3,101 @@
 
 #include "zones.h"
 #include "configmanager.h"
+#include "game.h"
 
+#include <gtl/phmap.hpp>
 #include <toml++/toml.hpp>
 
 extern ConfigManager g_config;
+extern Game g_game;
 
 std::vector<Zone> g_zones = { Zone(0) };
-std::multimap<Position, int> p_zones = {};
+
+namespace {
+
+// Zone membership is indexed by 8x8 chunks of a floor, each position holds the number of
+// its zone set. Only chunks with zones in them exist, and the few distinct combinations
+// of zones are stored once however many positions are in them.
+constexpr int32_t ZONE_CHUNK_BITS = 3;
+constexpr int32_t ZONE_CHUNK_SIZE = 1 << ZONE_CHUNK_BITS;
+constexpr int32_t ZONE_CHUNK_MASK = ZONE_CHUNK_SIZE - 1;
+
+using ZoneChunk = std::array<uint16_t, ZONE_CHUNK_SIZE * ZONE_CHUNK_SIZE>;
+
+gtl::flat_hash_map<uint64_t, ZoneChunk> zoneChunks;
+std::vector<ZoneSet> zoneSets = { ZoneSet() };
+std::map<ZoneSet, uint16_t> zoneSetIds = { { ZoneSet(), 0 } };
+gtl::flat_hash_map<uint32_t, uint16_t> zoneSetAdditions; // (set << 16) | zone to the set with the zone added
+// rectangles are kept as they are and tested on lookup, tiles cache the result
+std::array<std::vector<std::pair<ZoneArea, uint16_t>>, MAP_MAX_LAYERS> zoneAreas;
+
+uint64_t getChunkKey(const Position& position)
+{
+	return (static_cast<uint64_t>(position.z) << 32) | (static_cast<uint64_t>(position.y >> ZONE_CHUNK_BITS) << 16) | (position.x >> ZONE_CHUNK_BITS);
+}
+
+uint32_t getChunkIndex(const Position& position)
+{
+	return (position.x & ZONE_CHUNK_MASK) * ZONE_CHUNK_SIZE + (position.y & ZONE_CHUNK_MASK);
+}
+
+uint16_t addToZoneSet(const uint16_t setId, const uint16_t zoneId)
+{
+	const uint32_t key = (static_cast<uint32_t>(setId) << 16) | zoneId;
+	if (auto it = zoneSetAdditions.find(key); it != zoneSetAdditions.end()) {
+		return it->second;
+	}
+
+	ZoneSet zones = zoneSets[setId];
+	auto position = std::lower_bound(zones.begin(), zones.end(), zoneId);
+	if (position != zones.end() and *position == zoneId) {
+		return setId;
+	}
+	zones.insert(position, zoneId);
+
+	uint16_t newSetId;
+	if (auto it = zoneSetIds.find(zones); it != zoneSetIds.end()) {
+		newSetId = it->second;
+	} else if (zoneSets.size() <= std::numeric_limits<uint16_t>::max()) {
+		newSetId = static_cast<uint16_t>(zoneSets.size());
+		zoneSetIds.emplace(zones, newSetId);
+		zoneSets.push_back(std::move(zones));
+	} else {
+		std::cout << "[Warning - Zones] Too many overlapping zone combinations, zone " << zoneId << " is left out of some positions." << std::endl;
+		return setId;
+	}
+
+	zoneSetAdditions.emplace(key, newSetId);
+	return newSetId;
+}
+
+void indexZone(const Zone& zone)
+{
+	const uint16_t zoneId = static_cast<uint16_t>(zone.id);
+	for (const auto& position : zone.positions)
+	{
+		uint16_t& setId = zoneChunks[getChunkKey(position)][getChunkIndex(position)];
+		setId = addToZoneSet(setId, zoneId);
+	}
+
+	for (const auto& area : zone.areas)
+	{
+		for (int32_t z = area.from.z; z <= std::min<int32_t>(area.to.z, MAP_MAX_LAYERS - 1); ++z)
+		{
+			zoneAreas[z].emplace_back(area, zoneId);
+		}
+	}
+
+	// tiles may also be in areas of other zones, so their own set is extended
+	zone.forEachPosition([zoneId](const Position& position) {
+		if (const auto& tile = g_game.map.getTile(position))
+		{
+			tile->setZoneSetId(addToZoneSet(tile->getZoneSetId(), zoneId));
+		}
+	});
+}
+
+}
 
 size_t Zones::count()
 {
@@ -24,24 +112,52 @@ std::vector<Zone>& Zones::get()
 Zone& Zones::getZone(int id)
 {
 	auto& zones = Zones::get();
+	if (id < 0 or static_cast<size_t>(id) >= zones.size())
+	{
+		// the default zone, its id of 0 tells callers there is no such zone
+		return zones.front();
+	}
 	return zones[id];
 }
 
-std::vector<int> Zones::getZonesByPosition(const Position& position)
+const ZoneSet& Zones::getZonesByPosition(const Position& position)
+{
+	return zoneSets[getZoneSetId(position)];
+}
+
+uint16_t Zones::getZoneSetId(const Position& position)
 {
-	std::vector<int> result;
-	auto range = p_zones.equal_range(position);
+	uint16_t setId = 0;
+	if (auto it = zoneChunks.find(getChunkKey(position)); it != zoneChunks.end())
+	{
+		setId = it->second[getChunkIndex(position)];
+	}
 
-	for (auto& it = range.first; it != range.second; ++it)
+	if (position.z < MAP_MAX_LAYERS)
 	{
-		result.push_back(it->second);
+		for (const auto& [area, zoneId] : zoneAreas[position.z])
+		{
+			if (area.contains(position))
+			{
+				setId = addToZoneSet(setId, zoneId);
+			}
+		}
 	}
+	return setId;
+}
 
-	return result;
+const ZoneSet& Zones::getZoneSet(const uint16_t id)
+{
+	return id < zoneSets.size() ? zoneSets[id] : zoneSets.front();
 }
 
 bool Zones::registerZone(Zone zone)
 {
+	if (not isValidId(zone.id))
+	{
+		return false;
+	}
+
 	auto& zones = Zones::get();
 	if (zone.id < zones.size() and zones[zone.id].id == zone.id)
 	{
@@ -53,16 +169,13 @@ bool Zones::registerZone(Zone zone)
 		zones.resize(static_cast<std::vector<Zone, std::allocator<Zone>>::size_type>(zone.id) + 1);
 	}
 
-	for (const auto& position : zone.positions)
-	{
-		p_zones.insert(std::make_pair(position, zone.id));
-	}
+	indexZone(zone);
 
 	zones[zone.id] = std::move(zone);
 	return true;
 }
 
-// warning, don't use 0 as the id, it's not properly handled
+// warning, the id must be checked with Zones::isValidId first
 Zone& Zones::createZone(int id, std::vector<Position> positions)
 {
 	auto& zones = Zones::get();
@@ -78,16 +191,23 @@ Zone& Zones::createZone(int id, std::vector<Position> positions)
 		zones.resize(static_cast<std::vector<Zone, std::allocator<Zone>>::size_type>(id) + 1);
 	}
 
-	for (const auto& position : positions)
-	{
-		p_zones.insert(std::make_pair(position, id));
-	}
-
 	newZone.positions = std::move(positions);
+	indexZone(newZone);
+
 	auto& zoneRef = zones[id] = std::move(newZone);
 	return zoneRef;
 }
 
+bool Zones::isValidId(const int64_t id)
+{
+	if (id <= 0 or id > Zone::MAX_ID)
+	{
+		std::cout << "[Warning - Zones] Zone id " << id << " is out of range, ids go from 1 to " << Zone::MAX_ID << '.' << std::endl;
+		return false;
+	}
+	return true;
+}
+
 void Zones::load()
 {
 	auto folder = "data/world/" + g_config.getString(ConfigManager::MAP_NAME) + "-zones";
@@ -110,29 +230,57 @@ void Zones::load()
 								const toml::table& zoneTable = *zoneEntry.as_table();
 								auto id = zoneTable["id"];
 								auto posArray = zoneTable["positions"];
-								if (id and id.is_integer() and posArray and posArray.is_array())
+								auto areaArray = zoneTable["areas"];
+								if (id and id.is_integer() and ((posArray and posArray.is_array()) or (areaArray and areaArray.is_array())))
 								{
-									uint16_t zoneId = static_cast<uint16_t>(id.value_or(0));
-
-									if (zoneId == 0)
+									const int64_t zoneId = id.value_or(int64_t{0});
+									if (not isValidId(zoneId))
 									{
-										// log / error id should not be 0;
 										continue;
 									}
 									std::vector<Position> positions{};
-									for (const auto& position : *posArray.as_array())
+									std::vector<ZoneArea> areas{};
+									if (posArray.is_array())
 									{
-										if (position.is_table())
+										for (const auto& position : *posArray.as_array())
 										{
-											const toml::table& position_data = *position.as_table();
-											uint16_t x = static_cast<uint16_t>(position_data["x"].value_or(0));
-											uint16_t y = static_cast<uint16_t>(position_data["y"].value_or(0));
-											uint8_t z = static_cast<uint8_t>(position_data["z"].value_or(0));
-											positions.emplace_back(x, y, z);
+											if (position.is_table())
+											{
+												const toml::table& position_data = *position.as_table();
+												uint16_t x = static_cast<uint16_t>(position_data["x"].value_or(0));
+												uint16_t y = static_cast<uint16_t>(position_data["y"].value_or(0));
+												uint8_t z = static_cast<uint8_t>(position_data["z"].value_or(0));
+												positions.emplace_back(x, y, z);
+											}
 										}
 									}
-									auto zone = Zone(zoneId);
+
+									// rectangles, { from = { x, y, z }, to = { x, y, z } } with every floor in between
+									if (areaArray.is_array())
+									{
+										for (const auto& area : *areaArray.as_array())
+										{
+											if (not area.is_table())
+											{
+												continue;
+											}
+
+											const toml::table& area_data = *area.as_table();
+											const auto from = area_data["from"];
+											const auto to = area_data["to"];
+											const uint16_t fromX = static_cast<uint16_t>(from["x"].value_or(0));
+											const uint16_t fromY = static_cast<uint16_t>(from["y"].value_or(0));
+											const uint8_t fromZ = static_cast<uint8_t>(from["z"].value_or(0));
+											const uint16_t toX = static_cast<uint16_t>(to["x"].value_or(fromX));
+											const uint16_t toY = static_cast<uint16_t>(to["y"].value_or(fromY));
+											const uint8_t toZ = static_cast<uint8_t>(to["z"].value_or(fromZ));
+
+											areas.emplace_back(Position(fromX, fromY, fromZ), Position(toX, toY, toZ));
+										}
+									}
+									auto zone = Zone(static_cast<int>(zoneId));
 									zone.positions = std::move(positions);
+									zone.areas = std::move(areas);
 									if (auto registered = Zones::registerZone(std::move(zone)))
 									{
 										// success!
@@ -169,8 +317,47 @@ void Zones::load()
 
 void Zones::clear()
 {
-	g_zones.clear();
-	p_zones.clear();
+	for (const auto& [key, chunk] : zoneChunks)
+	{
+		for (uint32_t i = 0; i < chunk.size(); ++i)
+		{
+			if (chunk[i] == 0)
+			{
+				continue;
+			}
+
+			const uint16_t x = static_cast<uint16_t>(((key & 0xFFFF) << ZONE_CHUNK_BITS) + i / ZONE_CHUNK_SIZE);
+			const uint16_t y = static_cast<uint16_t>((((key >> 16) & 0xFFFF) << ZONE_CHUNK_BITS) + i % ZONE_CHUNK_SIZE);
+			if (const auto& tile = g_game.map.getTile(x, y, static_cast<uint8_t>(key >> 32)))
+			{
+				tile->setZoneSetId(0);
+			}
+		}
+	}
+
+	for (uint8_t z = 0; z < MAP_MAX_LAYERS; ++z)
+	{
+		for (const auto& [area, zoneId] : zoneAreas[z])
+		{
+			for (int32_t y = area.from.y; y <= area.to.y; ++y)
+			{
+				for (int32_t x = area.from.x; x <= area.to.x; ++x)
+				{
+					if (const auto& tile = g_game.map.getTile(x, y, z))
+					{
+						tile->setZoneSetId(0);
+					}
+				}
+			}
+		}
+		zoneAreas[z].clear();
+	}
+
+	g_zones = { Zone(0) };
+	zoneChunks.clear();
+	zoneSets = { ZoneSet() };
+	zoneSetIds = { { ZoneSet(), 0 } };
+	zoneSetAdditions.clear();
 }
 
 void Zones::reload()
@@ -3,25 +3,86 @@
 
 // alex rider
 
+#ifndef FS_ZONES_H
+#define FS_ZONES_H
+
 #include "otpch.h"
 #include "position.h"
 
+// a rectangle of positions, from holds the lowest and to the highest coordinates
+struct ZoneArea {
+	ZoneArea(const Position& from, const Position& to) :
+		from(std::min(from.x, to.x), std::min(from.y, to.y), std::min(from.z, to.z)),
+		to(std::max(from.x, to.x), std::max(from.y, to.y), std::max(from.z, to.z)) {}
+
+	bool contains(const Position& position) const {
+		return position.x >= from.x and position.x <= to.x and position.y >= from.y and position.y <= to.y and position.z >= from.z and position.z <= to.z;
+	}
+
+	size_t size() const {
+		return static_cast<size_t>(to.x - from.x + 1) * (to.y - from.y + 1) * (to.z - from.z + 1);
+	}
+
+	Position from;
+	Position to;
+};
+
 struct Zone {
+	// zone ids are stored as 16 bits in the zone sets, 0 is not a zone
+	static constexpr int MAX_ID = std::numeric_limits<uint16_t>::max();
+
 	Zone() : id(0) {}
 	Zone(int id) : id(id) {};
 	int id = 0;
 	std::vector<Position> positions{};
+	std::vector<ZoneArea> areas{};
+
+	size_t getPositionCount() const {
+		size_t count = positions.size();
+		for (const auto& area : areas) {
+			count += area.size();
+		}
+		return count;
+	}
+
+	// calls func with every position of the zone, single positions first and then the areas
+	template<typename Func>
+	void forEachPosition(Func&& func) const {
+		for (const auto& position : positions) {
+			func(position);
+		}
+
+		for (const auto& area : areas) {
+			for (int32_t z = area.from.z; z <= area.to.z; ++z) {
+				for (int32_t y = area.from.y; y <= area.to.y; ++y) {
+					for (int32_t x = area.from.x; x <= area.to.x; ++x) {
+						func(Position(x, y, z));
+					}
+				}
+			}
+		}
+	}
 };
 
+// the ids of the zones a position is in, sorted; positions in the same zones share one
+using ZoneSet = std::vector<uint16_t>;
+
 class Zones {
 public:
 	static bool registerZone(Zone zone);
 	static Zone& createZone(int id, std::vector<Position> positions);
+	static bool isValidId(int64_t id);
 	static void load();
 	static void clear();
 	static void reload();
 	static size_t count();
 	static std::vector<Zone>& get();
 	static Zone& getZone(int id);
-	static std::vector<int> getZonesByPosition(const Position& position);
-};
\ No newline at end of file
+	static const ZoneSet& getZonesByPosition(const Position& position);
+
+	// zone sets are numbered, 0 is the empty one; tiles keep the number of theirs
+	static uint16_t getZoneSetId(const Position& position);
+	static const ZoneSet& getZoneSet(uint16_t id);
+};
+
+#endif